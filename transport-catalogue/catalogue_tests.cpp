@@ -0,0 +1,214 @@
+//Проверки справочника на входных данных, которые базовая версия принимала
+#include "geo.h"
+#include "perfect_hash.h"
+#include "transport_catalogue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+using transport_catalogue::TransportCatalogue;
+using transport_catalogue::domain::PerfectHash;
+
+namespace {
+
+std::atomic<int> failure_count{ 0 };
+
+void Check(bool condition, const std::string& message) {
+	if (!condition) {
+		if (failure_count++ < 10) {
+			std::cerr << "FAILED: " << message << std::endl;
+		}
+	}
+}
+
+//Из остановок и автобусов с одинаковым именем по имени находится последний,
+//до и после финализации, в том числе в версии справочника
+void TestDuplicateNames() {
+	const auto hash = PerfectHash::Build({ "A"sv, "B"sv, "A"sv });
+	Check(hash.has_value(), "perfect hash is built over equal keys");
+	if (hash) {
+		Check(hash->size() == 3, "perfect hash covers all keys");
+		Check(hash->Find("A"sv) == 2u, "perfect hash gives the last equal key");
+		Check(hash->Find("B"sv) == 1u, "perfect hash gives a unique key");
+	}
+
+	TransportCatalogue db;
+	db.AddStop("A"sv, transport_catalogue::geo::Coordinates{ 55.60, 37.60 });
+	db.AddStop("B"sv, transport_catalogue::geo::Coordinates{ 55.61, 37.60 });
+	db.AddStop("A"sv, transport_catalogue::geo::Coordinates{ 55.62, 37.60 });
+	db.SetStopDistance("A"sv, "B"sv, 1000);
+	db.AddStop("C"sv, transport_catalogue::geo::Coordinates{ 55.63, 37.60 });
+	db.SetStopDistance("B"sv, "C"sv, 2000);
+	db.AddBus("X"sv, std::vector<std::string>{ "A"s, "B"s }, false);
+	db.AddBus("X"sv, std::vector<std::string>{ "B"s, "C"s }, false);
+	Check(db.FindStopId("A"sv) == 2u, "last stop wins before finalization");
+	Check(db.FindBusId("X"sv) == 1u, "last bus wins before finalization");
+
+	db.Finalize();
+	Check(db.FindStopId("A"sv) == 2u, "last stop wins after finalization");
+	Check(db.FindBusId("X"sv) == 1u, "last bus wins after finalization");
+	Check(db.GetBusStat("X"sv)->length_curv == 4000, "bus request answers for the last bus");
+
+	auto version = db.Fork();
+	version.AddStop("B"sv, transport_catalogue::geo::Coordinates{ 55.64, 37.60 });
+	Check(version.FindStopId("B"sv) == 4u, "stop added after finalization wins");
+	version.Finalize();
+	Check(version.FindStopId("B"sv) == 4u, "stop added after finalization wins after finalization");
+	Check(db.FindStopId("B"sv) == 1u, "catalogue is not changed by its version");
+}
+
+//Совпадающие точки находятся на нулевом расстоянии, как в формуле по координатам:
+//остановка, повторенная подряд, не добавляет длины пути
+void TestRepeatedStop() {
+	using namespace transport_catalogue::geo;
+	const Coordinates from{ 55.611087, 37.20829 };
+	const Coordinates to{ 55.50123, 37.50171 };
+	const UnitVector points[] = { ToUnitVector(from), ToUnitVector(to), ToUnitVector(to) };
+	double distances[2] = {};
+	ComputeSegmentDistances(points, 3, distances);
+	Check(distances[1] == 0, "segment between equal points is 0");
+	Check(ComputeDistance(points[1], points[2]) == 0, "distance between equal points is 0");
+	Check(std::abs(distances[0] - ComputeDistance(from, to)) < 1e-6, "segment matches coordinate formula");
+
+	TransportCatalogue db;
+	db.AddStop("From"sv, from);
+	db.AddStop("To"sv, to);
+	db.SetStopDistance("From"sv, "To"sv, 2000);
+	db.SetStopDistance("To"sv, "To"sv, 100);
+	db.AddBus("Repeat"sv, std::vector<std::string>{ "From"s, "To"s, "To"s }, false);
+	db.Finalize();
+	const auto stat = db.GetBusStat("Repeat"sv);
+	Check(stat->length_geo == 2 * distances[0], "repeated stop adds no geographic length");
+}
+
+//Ближайшие остановки отбираются и упорядочиваются по точному расстоянию,
+//даже когда для города пригодна приближенная метрика
+void TestNearestStops() {
+	using namespace transport_catalogue::geo;
+	const int side = 20;
+	TransportCatalogue db;
+	std::vector<Coordinates> coordinates;
+	for (int i = 0; i < side; ++i) {
+		for (int j = 0; j < side; ++j) {
+			coordinates.push_back({ 55.55 + 0.37 * i / side + 0.0013 * j, 37.35 + 0.55 * j / side + 0.0007 * i });
+			db.AddStop("Stop "s + std::to_string(coordinates.size()), coordinates.back());
+		}
+	}
+	db.Finalize();
+
+	const Coordinates points[] = { { 55.75, 37.62 }, { 55.56, 37.36 }, { 55.90, 37.88 } };
+	for (const Coordinates point : points) {
+		//Все остановки по возрастанию точного расстояния
+		const UnitVector point_vector = ToUnitVector(point);
+		std::vector<std::pair<double, size_t>> expected;
+		for (size_t stop = 0; stop < coordinates.size(); ++stop) {
+			expected.push_back({ ComputeDistance(point_vector, ToUnitVector(coordinates[stop])), stop });
+		}
+		std::sort(expected.begin(), expected.end());
+		for (const size_t count : { size_t{ 1 }, size_t{ 10 }, coordinates.size() }) {
+			//Радиус посередине между соседними остановками, не ближе сантиметра к каждой
+			for (const size_t within : { size_t{ 5 }, size_t{ 150 }, size_t{ 390 } }) {
+				const double radius = (expected[within - 1].first + expected[within].first) / 2;
+				if (radius - expected[within - 1].first < 0.01) {
+					continue;
+				}
+				const auto nearest = db.FindNearestStops(point, count, radius);
+				const size_t expected_size = std::min(count, within);
+				Check(nearest.size() == expected_size, "nearest stops are cut by exact distance");
+				for (size_t i = 0; i < std::min(nearest.size(), expected_size); ++i) {
+					Check(nearest[i].first == expected[i].second, "nearest stops are ordered by exact distance");
+					Check(std::abs(nearest[i].second - expected[i].first) < 0.01, "nearest stop distance is exact");
+				}
+			}
+		}
+	}
+}
+
+//Списки автобусов, измененные в версиях справочника, после финализации версии
+//переносятся в общие списки, а прежние версии видят свои списки
+void TestForkedStopBuses() {
+	using transport_catalogue::domain::BusId;
+	using transport_catalogue::domain::StopId;
+	const StopId stop_count = 16;
+	TransportCatalogue db;
+	for (StopId stop = 0; stop < stop_count; ++stop) {
+		db.AddStop("Stop "s + std::to_string(stop), transport_catalogue::geo::Coordinates{ 55.6 + stop * 0.001, 37.6 });
+	}
+	for (StopId from = 0; from < stop_count; ++from) {
+		for (StopId to = 0; to < stop_count; ++to) {
+			db.SetStopDistance("Stop "s + std::to_string(from), "Stop "s + std::to_string(to), 100);
+		}
+	}
+	std::vector<std::string> first_half;
+	std::vector<std::string> second_half;
+	for (StopId stop = 0; stop < stop_count; ++stop) {
+		(stop < stop_count / 2 ? first_half : second_half).push_back("Stop "s + std::to_string(stop));
+	}
+	db.AddBus("A"sv, first_half, true);
+	db.AddBus("B"sv, second_half, true);
+	db.Finalize();
+
+	//Автобусы остановок по версиям: автобус A версии k проходит через остановки [k, k + stop_count / 2)
+	auto expected_buses = [stop_count](StopId stop, StopId shift) {
+		std::vector<BusId> buses;
+		if (stop >= shift && stop < shift + stop_count / 2) {
+			buses.push_back(0);
+		}
+		if (stop >= stop_count / 2) {
+			buses.push_back(1);
+		}
+		return buses;
+	};
+	auto check_version = [&](const TransportCatalogue& version, StopId shift, const std::string& message) {
+		const auto& index = version.GetStopBusIndex();
+		for (StopId stop = 0; stop < stop_count; ++stop) {
+			const auto buses = index.GetBuses(stop);
+			Check(std::vector<BusId>(buses.begin(), buses.end()) == expected_buses(stop, shift), message);
+		}
+	};
+
+	std::vector<TransportCatalogue> versions;
+	versions.push_back(db.Fork());
+	for (StopId shift = 1; shift <= stop_count / 2; ++shift) {
+		auto version = versions.back().Fork();
+		std::vector<StopId> stops;
+		for (StopId stop = shift; stop < shift + stop_count / 2; ++stop) {
+			stops.push_back(stop);
+		}
+		stops.push_back(shift);
+		version.UpdateBus(0, stops, true);
+		check_version(version, shift, "changed lists before finalization");
+		version.Finalize();
+		check_version(version, shift, "changed lists after finalization");
+		versions.push_back(std::move(version));
+	}
+	for (StopId shift = 0; shift < versions.size(); ++shift) {
+		check_version(versions[shift], shift, "earlier version keeps its lists");
+	}
+	//Списки последней версии изменены у многих остановок и хранятся подряд
+	const auto& index = versions.back().GetStopBusIndex();
+	for (StopId stop = 0; stop + 1 < stop_count; ++stop) {
+		Check(index.GetBuses(stop).end() == index.GetBuses(stop + 1).begin(), "changed lists are merged");
+	}
+}
+
+}//end namespace
+
+int main() {
+	TestDuplicateNames();
+	TestRepeatedStop();
+	TestNearestStops();
+	TestForkedStopBuses();
+	if (failure_count > 0) {
+		std::cerr << failure_count << " checks failed" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "catalogue tests passed" << std::endl;
+	return EXIT_SUCCESS;
+}
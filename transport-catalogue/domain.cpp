@@ -10,9 +10,12 @@ bool StopPair::operator==(const StopPair& other) const {
 	return this->from == other.from && this->to == other.to;
 }
 
-size_t StopPairHasher::operator()(const StopPair& stop_pair) const {
-	return std::hash<std::string_view>{}(stop_pair.from->name) +
-		std::hash<std::string_view>{}(stop_pair.to->name) * 43;
+size_t HashRouteStops(const StopId* stops, size_t count, bool is_roundtrip) {
+	size_t hash = is_roundtrip;
+	for (size_t i = 0; i < count; ++i) {
+		hash = hash * 43 + stops[i];
+	}
+	return hash;
 }
 
 }//end namespace domain
@@ -1,7 +1,11 @@
 #pragma once
 #include "geo.h"
+#include "paged_vector.h"
+#include "ranges.h"
 
-#include <set>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -10,6 +14,10 @@ namespace transport_catalogue {
 
 namespace domain {
 
+//Плотные идентификаторы, назначаются по порядку добавления в справочник
+using StopId = uint32_t;
+using BusId = uint32_t;
+
 struct BusStat {
 	const std::string_view name;
 	size_t stops_count = 0;
@@ -20,34 +28,148 @@ struct BusStat {
 
 struct StopStat {
 	const std::string_view name;
-	const std::set<std::string_view>& buses;
+	//Идентификаторы автобусов, упорядоченные по имени
+	ranges::Range<const BusId*> buses;
 };
 
-//Остановка
+//Остановка. Координаты хранятся отдельно, в StopsHotData справочника
 struct Stop {
-	std::string name;
-	geo::Coordinates coordinates;
+	//Имя хранится в NameArena справочника
+	std::string_view name;
+	StopId id = 0;
 };
 
-//Автобус (маршрут)
-struct Bus {
-	std::string name;
-	std::vector<const Stop*> stops;
+//Часто используемые данные остановок в параллельных массивах,
+//индексируемых идентификатором остановки. Хранятся отдельно от имен,
+//чтобы массовые проходы по координатам читали память подряд.
+//Страницы массивов общие с версиями справочника до изменения
+struct StopsHotData {
+	PagedVector<int32_t> lat;
+	PagedVector<int32_t> lng;
+	//Положение на единичной сфере для быстрого вычисления расстояний
+	PagedVector<geo::UnitVector> unit_vectors;
+
+	void Reserve(size_t count) {
+		lat.reserve(count);
+		lng.reserve(count);
+		unit_vectors.reserve(count);
+	}
+	void Add(geo::FixedCoordinates coordinates) {
+		lat.push_back(coordinates.lat);
+		lng.push_back(coordinates.lng);
+		unit_vectors.push_back(geo::ToUnitVector(coordinates.ToCoordinates()));
+	}
+	void Set(StopId id, geo::FixedCoordinates coordinates) {
+		lat.GetMutable(id) = coordinates.lat;
+		lng.GetMutable(id) = coordinates.lng;
+		unit_vectors.GetMutable(id) = geo::ToUnitVector(coordinates.ToCoordinates());
+	}
+	geo::FixedCoordinates GetCoordinates(StopId id) const {
+		return { lat[id], lng[id] };
+	}
+	size_t size() const {
+		return lat.size();
+	}
+};
+
+//Полная последовательность остановок пути без копирования: для некольцевого пути
+//за прямым направлением следует обратное без повторения конечной остановки
+class RouteStopsView {
+public:
+	class Iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = StopId;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const StopId*;
+		using reference = StopId;
+
+		Iterator(const RouteStopsView* view, difference_type index)
+			: view_(view), index_(index) {}
+
+		StopId operator*() const { return (*view_)[index_]; }
+		StopId operator[](difference_type n) const { return (*view_)[index_ + n]; }
+		Iterator& operator++() { ++index_; return *this; }
+		Iterator operator++(int) { Iterator result = *this; ++index_; return result; }
+		Iterator& operator--() { --index_; return *this; }
+		Iterator operator--(int) { Iterator result = *this; --index_; return result; }
+		Iterator& operator+=(difference_type n) { index_ += n; return *this; }
+		Iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+		Iterator operator+(difference_type n) const { return { view_, index_ + n }; }
+		Iterator operator-(difference_type n) const { return { view_, index_ - n }; }
+		difference_type operator-(const Iterator& other) const { return index_ - other.index_; }
+		bool operator==(const Iterator& other) const { return index_ == other.index_; }
+		bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+		bool operator<(const Iterator& other) const { return index_ < other.index_; }
+		bool operator>(const Iterator& other) const { return index_ > other.index_; }
+		bool operator<=(const Iterator& other) const { return index_ <= other.index_; }
+		bool operator>=(const Iterator& other) const { return index_ >= other.index_; }
+
+	private:
+		const RouteStopsView* view_;
+		difference_type index_;
+	};
+
+	//stops и stored_count задают остановки пути в том виде, в котором они хранятся
+	RouteStopsView(const StopId* stops, size_t stored_count, bool is_roundtrip)
+		: stops_(stops)
+		, stored_count_(stored_count)
+		, size_(is_roundtrip || stored_count == 0 ? stored_count : stored_count * 2 - 1) {}
+
+	StopId operator[](size_t index) const {
+		return index < stored_count_ ? stops_[index] : stops_[size_ - 1 - index];
+	}
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	StopId front() const { return stops_[0]; }
+	StopId back() const { return (*this)[size_ - 1]; }
+	Iterator begin() const { return { this, 0 }; }
+	Iterator end() const { return { this, static_cast<std::ptrdiff_t>(size_) }; }
+
+	//Хранимые остановки: для некольцевого пути только прямое направление
+	ranges::Range<const StopId*> GetStored() const {
+		return { stops_, stops_ + stored_count_ };
+	}
+
+private:
+	const StopId* stops_;
+	size_t stored_count_;
+	size_t size_;
+};
+
+//Путь следования, общий для автобусов с одинаковой последовательностью остановок.
+//Остановки путей хранятся в справочнике подряд в общих страницах, см. TransportCatalogue::GetRouteStops
+struct Route {
 	bool is_roundtrip = false;
 	size_t unique_stops_count = 0;
+	//Автобусы, следующие по этому пути, в порядке добавления
+	std::vector<BusId> buses;
+	//Порядковый номер пути в справочнике
+	size_t id = 0;
+	//Длины пути, вычисляются при финализации справочника
+	double length_geo = 0;
+	int length_curv = 0;
+	bool has_length = false;
+};
+
+//Автобус (маршрут)
+struct Bus {
+	//Имя хранится в NameArena справочника
+	std::string_view name;
+	//Номер пути следования, см. TransportCatalogue::GetRoute
+	size_t route_id = 0;
+	BusId id = 0;
 };
 
 //Пара остановок для использования в ассоциативном контейнере
 struct StopPair {
-	const Stop* from;
-	const Stop* to;
+	StopId from;
+	StopId to;
 	bool operator==(const StopPair& other) const;
 };
 
-//Хэшер для пары остановок
-struct StopPairHasher {
-	size_t operator()(const StopPair& stop_pair) const;
-};
+//Хэш пути следования по хранимой последовательности остановок
+size_t HashRouteStops(const StopId* stops, size_t count, bool is_roundtrip);
 
 }//end namespace domain
 
@@ -1,5 +1,8 @@
 #include "geo.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace transport_catalogue {
 
 namespace geo {
@@ -15,6 +18,93 @@ double ComputeDistance(Coordinates from, Coordinates to) {
 		* ERTH_RADIUS;
 }
 
+UnitVector ToUnitVector(Coordinates coordinates) {
+	static const double dr = M_PI / 180.;
+	const double lat = coordinates.lat * dr;
+	const double lng = coordinates.lng * dr;
+	return { cos(lat) * cos(lng), cos(lat) * sin(lng), sin(lat) };
+}
+
+namespace {
+
+//Длина векторного произведения - синус угла между векторами
+double CrossNorm(const UnitVector& from, const UnitVector& to) {
+	const double x = from.y * to.z - from.z * to.y;
+	const double y = from.z * to.x - from.x * to.z;
+	const double z = from.x * to.y - from.y * to.x;
+	return std::sqrt(x * x + y * y + z * z);
+}
+
+//Скалярное произведение - косинус угла между векторами
+double Dot(const UnitVector& from, const UnitVector& to) {
+	return from.x * to.x + from.y * to.y + from.z * to.z;
+}
+
+}//end namespace
+
+//Угол через atan2 точен и для близких точек, где acos скалярного произведения
+//теряет точность, а для совпадающих точек дает ровно 0
+double ComputeDistance(const UnitVector& from, const UnitVector& to) {
+	return atan2(CrossNorm(from, to), Dot(from, to)) * ERTH_RADIUS;
+}
+
+void ComputeSegmentDistances(const UnitVector* points, size_t count, double* distances) {
+	if (count < 2) {
+		return;
+	}
+	const size_t segment_count = count - 1;
+	for (size_t i = 0; i < segment_count; ++i) {
+		distances[i] = CrossNorm(points[i], points[i + 1]);
+	}
+	for (size_t i = 0; i < segment_count; ++i) {
+		distances[i] = atan2(distances[i], Dot(points[i], points[i + 1])) * ERTH_RADIUS;
+	}
+}
+
+// ---------- FastDistance ------------------
+double FastDistance::operator()(Coordinates from, Coordinates to) const {
+	const double dy = (to.lat - from.lat) * lat_scale_;
+	const double dx = (to.lng - from.lng) * lng_scale_;
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+double FastDistance::LowerBound(Coordinates from, Coordinates to) const {
+	return (*this)(from, to) * std::max(0., 1 - 2 * max_relative_error_);
+}
+
+bool FastDistance::IsAccurate() const {
+	return max_relative_error_ <= FAST_DISTANCE_MAX_ERROR;
+}
+
+void FastDistance::Init(double min_lat, double max_lat, double min_lng, double max_lng) {
+	static const double dr = M_PI / 180.;
+	static const int GRID_SIZE = 5;
+	static const double MIN_CHECKED_DISTANCE = 1.;
+	lat_scale_ = dr * ERTH_RADIUS;
+	lng_scale_ = cos((min_lat + max_lat) / 2 * dr) * dr * ERTH_RADIUS;
+	//Погрешность растет к краям города, поэтому проверяются все пары узлов
+	//сетки GRID_SIZE x GRID_SIZE, натянутой на его границы
+	std::vector<Coordinates> grid;
+	grid.reserve(GRID_SIZE * GRID_SIZE);
+	for (int i = 0; i < GRID_SIZE; ++i) {
+		for (int j = 0; j < GRID_SIZE; ++j) {
+			grid.push_back({ min_lat + (max_lat - min_lat) * i / (GRID_SIZE - 1),
+				min_lng + (max_lng - min_lng) * j / (GRID_SIZE - 1) });
+		}
+	}
+	max_relative_error_ = 0;
+	for (size_t i = 0; i < grid.size(); ++i) {
+		for (size_t j = i + 1; j < grid.size(); ++j) {
+			const double exact = ComputeDistance(grid[i], grid[j]);
+			if (exact < MIN_CHECKED_DISTANCE) {
+				continue;
+			}
+			max_relative_error_ = std::max(max_relative_error_,
+				std::abs((*this)(grid[i], grid[j]) - exact) / exact);
+		}
+	}
+}
+
 } //end namespace geo
 
 } //end namespace transport_catalogue // namespace geo
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 
 namespace transport_catalogue {
 
@@ -9,6 +13,10 @@ namespace geo {
 
 static const double TRESHOLD = 1e-6;
 static const int ERTH_RADIUS = 6371000;
+//Максимальное расхождение (в метрах) расстояний, вычисленных через единичные векторы,
+//с ComputeDistance(Coordinates, Coordinates). Сама формула с acos точна примерно до 0.1 м.
+//Проверяется отладочной сборкой при вычислении длин путей
+static const double UNIT_VECTOR_DISTANCE_TOLERANCE = 0.2;
 
 struct Coordinates {
 	double lat;
@@ -21,8 +29,98 @@ struct Coordinates {
 	}
 };
 
+//Число единиц фиксированной точки в одном градусе
+static const double FIXED_COORDINATES_SCALE = 1e7;
+
+//Координаты в фиксированной точке: целое число десятимиллионных долей градуса.
+//Сравниваются точно, занимают вдвое меньше памяти, чем Coordinates
+struct FixedCoordinates {
+	int32_t lat = 0;
+	int32_t lng = 0;
+
+	static FixedCoordinates FromCoordinates(Coordinates coordinates) {
+		return { static_cast<int32_t>(std::lround(coordinates.lat * FIXED_COORDINATES_SCALE)),
+			static_cast<int32_t>(std::lround(coordinates.lng * FIXED_COORDINATES_SCALE)) };
+	}
+	Coordinates ToCoordinates() const {
+		return { lat / FIXED_COORDINATES_SCALE, lng / FIXED_COORDINATES_SCALE };
+	}
+	bool operator==(const FixedCoordinates& other) const {
+		return lat == other.lat && lng == other.lng;
+	}
+	bool operator!=(const FixedCoordinates& other) const {
+		return !(*this == other);
+	}
+};
+
+//Точка на единичной сфере, вычисляется один раз по широте и долготе
+struct UnitVector {
+	double x = 0;
+	double y = 0;
+	double z = 0;
+};
+
+UnitVector ToUnitVector(Coordinates coordinates);
+
 double ComputeDistance(Coordinates from, Coordinates to);
 
+double ComputeDistance(const UnitVector& from, const UnitVector& to);
+
+//Вычисляет расстояния между соседними точками ломаной:
+//distances[i] - расстояние от points[i] до points[i + 1], i < count - 1.
+//Векторные произведения и atan2 считаются отдельными проходами без ветвлений,
+//чтобы компилятор мог векторизовать оба цикла
+void ComputeSegmentDistances(const UnitVector* points, size_t count, double* distances);
+
+//Максимальная относительная погрешность, при которой приближенные расстояния
+//считаются пригодными для эвристик и пространственных запросов
+static const double FAST_DISTANCE_MAX_ERROR = 0.01;
+
+//Приближенное расстояние в пределах города по равнопромежуточной проекции
+//с опорной широтой в середине города. Не использует тригонометрию при вычислении,
+//погрешность для точек города оценивается при построении по узлам сетки, натянутой на город,
+//поэтому это оценка, а не гарантированная граница
+class FastDistance {
+public:
+	FastDistance() = default;
+
+	// points_begin и points_end задают начало и конец интервала элементов geo::Coordinates
+	template <typename PointInputIt>
+	FastDistance(PointInputIt points_begin, PointInputIt points_end);
+
+	double operator()(Coordinates from, Coordinates to) const;
+
+	//Нижняя оценка точного расстояния для точек города: приближенное расстояние
+	//с двойным запасом к оценке погрешности. Годится для отсечения, но не для ответа
+	double LowerBound(Coordinates from, Coordinates to) const;
+
+	//Возвращает true, если оценка погрешности не превышает FAST_DISTANCE_MAX_ERROR
+	bool IsAccurate() const;
+
+private:
+	void Init(double min_lat, double max_lat, double min_lng, double max_lng);
+
+	double lat_scale_ = 0;
+	double lng_scale_ = 0;
+	//Наибольшая относительная погрешность на узлах сетки
+	double max_relative_error_ = std::numeric_limits<double>::infinity();
+};
+
+template <typename PointInputIt>
+FastDistance::FastDistance(PointInputIt points_begin, PointInputIt points_end) {
+	if (points_begin == points_end) {
+		Init(0, 0, 0, 0);
+		return;
+	}
+	const auto [left_it, right_it] = std::minmax_element(
+		points_begin, points_end,
+		[](auto lhs, auto rhs) { return lhs.lng < rhs.lng; });
+	const auto [bottom_it, top_it] = std::minmax_element(
+		points_begin, points_end,
+		[](auto lhs, auto rhs) { return lhs.lat < rhs.lat; });
+	Init(bottom_it->lat, top_it->lat, left_it->lng, right_it->lng);
+}
+
 } //end namespace geo
 
 } //end namespace transport_catalogue
\ No newline at end of file
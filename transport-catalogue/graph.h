@@ -1,7 +1,10 @@
 #pragma once
 
+#include "paged_vector.h"
 #include "ranges.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <vector>
 
@@ -27,30 +30,53 @@ public:
 	DirectedWeightedGraph() = default;
 	explicit DirectedWeightedGraph(size_t vertex_count);
 	EdgeId AddEdge(const Edge<Weight>& edge);
+	//Добавляет count вершин без ребер, возвращает идентификатор первой из них
+	VertexId AddVertexes(size_t count);
+	//Убирает ребро из списка смежности. Идентификаторы и данные ребер не меняются
+	void RemoveEdge(EdgeId edge_id);
 
 	size_t GetVertexCount() const;
 	size_t GetEdgeCount() const;
 	const Edge<Weight>& GetEdge(EdgeId edge_id) const;
 	IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
 
+	//Память ребер и списков смежности в байтах
+	size_t GetEdgesMemoryUsage() const;
+	size_t GetIncidenceListsMemoryUsage() const;
+
 private:
-	std::vector<Edge<Weight>> edges_;
-	std::vector<IncidenceList> incidence_lists_;
+	//Копия графа разделяет страницы ребер и списков смежности с оригиналом
+	transport_catalogue::domain::PagedVector<Edge<Weight>> edges_;
+	transport_catalogue::domain::PagedVector<IncidenceList> incidence_lists_;
 };
 
 template <typename Weight>
-DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-	: incidence_lists_(vertex_count) {
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count) {
+	incidence_lists_.resize(vertex_count);
 }
 
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+	assert(edge.from < incidence_lists_.size());
 	edges_.push_back(edge);
 	const EdgeId id = edges_.size() - 1;
-	incidence_lists_.at(edge.from).push_back(id);
+	incidence_lists_.GetMutable(edge.from).push_back(id);
 	return id;
 }
 
+template <typename Weight>
+VertexId DirectedWeightedGraph<Weight>::AddVertexes(size_t count) {
+	const VertexId first = incidence_lists_.size();
+	incidence_lists_.resize(incidence_lists_.size() + count);
+	return first;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::RemoveEdge(EdgeId edge_id) {
+	auto& incidence_list = incidence_lists_.GetMutable(GetEdge(edge_id).from);
+	incidence_list.erase(std::find(incidence_list.begin(), incidence_list.end(), edge_id));
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
 	return incidence_lists_.size();
@@ -63,12 +89,28 @@ size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
 
 template <typename Weight>
 const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
-	return edges_.at(edge_id);
+	assert(edge_id < edges_.size());
+	return edges_[edge_id];
 }
 
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-	return ranges::AsRange(incidence_lists_.at(vertex));
+	assert(vertex < incidence_lists_.size());
+	return ranges::AsRange(incidence_lists_[vertex]);
+}
+
+template <typename Weight>
+size_t DirectedWeightedGraph<Weight>::GetEdgesMemoryUsage() const {
+	return edges_.GetMemoryUsage();
+}
+
+template <typename Weight>
+size_t DirectedWeightedGraph<Weight>::GetIncidenceListsMemoryUsage() const {
+	size_t bytes = incidence_lists_.GetMemoryUsage();
+	for (const auto& incidence_list : incidence_lists_) {
+		bytes += incidence_list.capacity() * sizeof(EdgeId);
+	}
+	return bytes;
 }
 }  // namespace graph
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include "json.h"
 
+#include <charconv>
+#include <iterator>
+
 using namespace std::literals;
 
 namespace json {
 
 static const std::string_view SPACES = " \n\r\t"sv; //Spaces
 static const std::string_view CHARS_TO_SHIELD = "\r\n\"\\"sv; //Escape sequences to shield
-static const std::string_view DIGITS = "-0123456789xX"sv;
+static const std::string_view NUMBER_CHARS = "+-.0123456789eE"sv; //Characters of numbers
 
 using Variant = std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string>;
 
@@ -108,19 +111,177 @@ const Node& Document::GetRoot() const {
 }
 
 Document Load(std::istream& input) {
-	std::vector<std::string> inp_data;
-	std::string line;
-	while (!input.eof()) {
-		std::getline(input, line);
-		inp_data.push_back(std::move(line));
+	const std::string text{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+	if (text.empty()) {
+		throw json::ParsingError("Empty File");
+	}
+	return Document{ parsing::LoadNode(text) };
+}
+
+// ---------- ViewNode ------------------
+bool ViewNode::IsArray() const {
+	return std::holds_alternative<ViewArray>(*this);
+}
+
+bool ViewNode::IsBool() const {
+	return std::holds_alternative<bool>(*this);
+}
+
+bool ViewNode::IsDouble() const { //Возвращает true, если в узле хранится int либо double.
+	return std::holds_alternative<double>(*this) || IsInt();
+}
+
+bool ViewNode::IsInt() const {
+	return std::holds_alternative<int>(*this);
+}
+
+bool ViewNode::IsNull() const {
+	return std::holds_alternative<std::nullptr_t>(*this);
+}
+
+bool ViewNode::IsMap() const {
+	return std::holds_alternative<ViewDict>(*this);
+}
+
+bool ViewNode::IsPureDouble() const {
+	return std::holds_alternative<double>(*this);
+}
+
+bool ViewNode::IsString() const {
+	return std::holds_alternative<std::string_view>(*this);
+}
+
+const ViewArray& ViewNode::AsArray() const {
+	if (!IsArray()) { throw std::logic_error("Not an array"s); }
+	return std::get<ViewArray>(*this);
+}
+
+bool ViewNode::AsBool() const {
+	if (!IsBool()) { throw std::logic_error("Not a bool"s); }
+	return std::get<bool>(*this);
+}
+
+int ViewNode::AsInt() const {
+	if (!IsInt()) { throw std::logic_error("Not an int"s); }
+	return std::get<int>(*this);
+}
+
+double ViewNode::AsDouble() const {
+	if (!IsDouble()) { throw std::logic_error("Not a double"s); }
+	return IsPureDouble() ? std::get<double>(*this) : static_cast<double>(AsInt());
+}
+
+const ViewDict& ViewNode::AsMap() const {
+	if (!IsMap()) { throw std::logic_error("Not a map"s); }
+	return std::get<ViewDict>(*this);
+}
+
+std::string_view ViewNode::AsString() const {
+	if (!IsString()) { throw std::logic_error("Not a string"s); }
+	return std::get<std::string_view>(*this);
+}
+
+ViewNode::Value& ViewNode::GetValue() {
+	return *this;
+}
+
+// ---------- ViewDocument ------------------
+ViewDocument::ViewDocument(std::string text)
+	: text_(std::make_unique<const std::string>(std::move(text)))
+	, root_(parsing::LoadViewNode(*text_, decoded_strings_)) {
+}
+
+const ViewNode& ViewDocument::GetRoot() const {
+	return root_;
+}
+
+size_t ViewDocument::GetStringsMemoryUsage() const {
+	size_t bytes = text_ ? text_->capacity() + 1 : 0;
+	for (const auto& str : decoded_strings_) {
+		bytes += str.capacity() + 1;
 	}
-	if (inp_data.empty()) {
+	return bytes;
+}
+
+ViewDocument::ViewDocument(std::deque<std::string> strings, ViewNode root)
+	: decoded_strings_(std::move(strings))
+	, root_(std::move(root)) {
+}
+
+ViewDocument LoadView(std::istream& input) {
+	std::string text{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+	if (text.empty()) {
 		throw json::ParsingError("Empty File");
 	}
-	for (const auto& str : inp_data) {
-		line.append(str);
+	return ViewDocument{ std::move(text) };
+}
+
+// ---------- ViewDocumentBuilder ------------------
+void ViewDocumentBuilder::StartDict() {
+	stack_.emplace_back(ViewDict{});
+}
+
+void ViewDocumentBuilder::Key(std::string_view key) {
+	assert(!stack_.empty() && stack_.back().IsMap());
+	keys_.push_back(strings_.emplace_back(key));
+}
+
+void ViewDocumentBuilder::EndDict() {
+	assert(!stack_.empty() && stack_.back().IsMap());
+	ViewNode dict = std::move(stack_.back());
+	stack_.pop_back();
+	AddValue(std::move(dict));
+}
+
+void ViewDocumentBuilder::StartArray() {
+	stack_.emplace_back(ViewArray{});
+}
+
+void ViewDocumentBuilder::EndArray() {
+	assert(!stack_.empty() && stack_.back().IsArray());
+	ViewNode array = std::move(stack_.back());
+	stack_.pop_back();
+	AddValue(std::move(array));
+}
+
+void ViewDocumentBuilder::Null() {
+	AddValue(ViewNode());
+}
+
+void ViewDocumentBuilder::Bool(bool value) {
+	AddValue(ViewNode(value));
+}
+
+void ViewDocumentBuilder::Int(int value) {
+	AddValue(ViewNode(value));
+}
+
+void ViewDocumentBuilder::Double(double value) {
+	AddValue(ViewNode(value));
+}
+
+void ViewDocumentBuilder::String(std::string_view value) {
+	AddValue(ViewNode(std::string_view{ strings_.emplace_back(value) }));
+}
+
+ViewDocument ViewDocumentBuilder::Build() {
+	assert(stack_.empty() && root_);
+	return ViewDocument{ std::move(strings_), std::move(*root_) };
+}
+
+void ViewDocumentBuilder::AddValue(ViewNode value) {
+	if (stack_.empty()) {
+		assert(!root_);
+		root_ = std::move(value);
+		return;
+	}
+	auto& parent = stack_.back().GetValue();
+	if (auto* array = std::get_if<ViewArray>(&parent)) {
+		array->push_back(std::move(value));
+		return;
 	}
-	return Document{ parsing::LoadNode(line) };
+	std::get<ViewDict>(parent).emplace(keys_.back(), std::move(value));
+	keys_.pop_back();
 }
 
 void Print(const Document& doc, std::ostream& output) {
@@ -247,134 +408,407 @@ void PrintWithEscapeSeq(const std::string& str, std::ostream& out) {
 
 namespace parsing {
 
-using namespace helpers;
-Node LoadNode(std::string_view str) {
-	size_t begin = str.find_first_not_of(SPACES);
-	if (begin == std::string::npos) {
-		throw json::ParsingError("Node is empty");
-	}
-	size_t end = str.find_last_not_of(SPACES);
-	str = str.substr(begin, end - begin + 1);
-	if (str.front() == '{' && str.back() == '}') {
-		return LoadDict(str);
-	}
-	if (str.front() == '[' && str.back() == ']') {
-		return LoadArray(str);
-	}
-	if (str.front() == '\"' && str.back() == '\"') {
-		return LoadString(str);
-	}
-	if (str == "null") {
-		return Node();
-	}
-	if (str == "false") {
-		return Node(false);
-	}
-	if (str == "true") {
-		return Node(true);
-	}
-	if (str.find_first_not_of(DIGITS) == std::string::npos) {
-		return LoadInt(str);
-	}
-	return LoadDouble(str);
-}
-
-Node LoadDict(std::string_view sv) {
-	Dict result;
-	if (sv.size() == 2) {
-		return Node(std::move(result));
-	}
-	sv.remove_prefix(1);
-	sv.remove_suffix(1);
-	size_t key_begin = FindKeyBegin(sv);
-	if (key_begin == std::string::npos) {
-		return Node(std::move(result));
-	}
-	size_t key_end = FindkeyEnd(sv, key_begin);
-	size_t value_begin = FindValueBegin(sv, key_end + 1);
-	size_t value_end = FindValueEnd(sv, value_begin);
-	while (key_begin != std::string::npos) {
-		std::string key{ sv.substr(key_begin, key_end - key_begin) };
-		Node value = LoadNode(sv.substr(value_begin, value_end - value_begin));
-		result.insert({ key, value });
-		key_begin = FindKeyBegin(sv, value_end);
-		key_end = FindkeyEnd(sv, key_begin);
-		value_begin = FindValueBegin(sv, key_end + 1);
-		value_end = FindValueEnd(sv, value_begin);
-	}
-	return Node(std::move(result));
-}
-
-Node LoadArray(std::string_view sv) {
-	Array result;
-	if (sv.size() == 2) {
-		return Node(std::move(result));
-	}
-	sv.remove_prefix(1);
-	sv.remove_suffix(1);
-	size_t begin = FindValueBegin(sv);
-	if (begin == std::string::npos) {
-		return Node(std::move(result));
-	}
-	size_t end = FindValueEnd(sv, begin);
-	while (begin != std::string::npos) {
-		result.push_back(LoadNode(sv.substr(begin, end - begin)));
-		begin = FindValueBegin(sv, end);
-		end = FindValueEnd(sv, begin);
-	}
-	return Node(std::move(result));
-}
-
-Node LoadString(std::string_view sv) {
-	sv.remove_prefix(1);
-	sv.remove_suffix(1);
-	std::string str;
-	size_t i = 0;
-	for (; i + 1 < sv.size(); ++i) {
-		if (sv[i] == '\\') {
-			str += UnshildedChar(sv[i + 1]);
-			++i;
-			continue;
-		} else {
-			str += sv[i];
+namespace {
+
+//Целое число, если оно помещается в int, иначе число с плавающей точкой
+std::variant<int, double> ReadNumber(std::string_view text) {
+	if (text.empty()) {
+		throw json::ParsingError("Undefined Node type");
+	}
+	const char* first = text.data();
+	const char* last = text.data() + text.size();
+	if (text.find_first_of(".eE"sv) == std::string_view::npos) {
+		int value = 0;
+		const auto [ptr, error] = std::from_chars(first, last, value);
+		if (error == std::errc{} && ptr == last) {
+			return value;
+		}
+		if (error != std::errc::result_out_of_range) {
+			throw json::ParsingError("Incorrect number");
 		}
 	}
-	if (i == sv.size() - 1) {
-		str += sv[i];
+	double value = 0;
+	const auto [ptr, error] = std::from_chars(first, last, value);
+	if (error != std::errc{} || ptr != last) {
+		throw json::ParsingError("Incorrect number");
 	}
-	return Node(std::move(str));
+	return value;
 }
 
-Node LoadInt(std::string_view sv) {
-	size_t count = 0;
-	int value = 0;
-	try {
-		value = std::stoi(std::string{ sv }, &count);
-	} catch (std::invalid_argument& e) {
-		throw json::ParsingError(e.what());
-	} catch (std::out_of_range& e) {
-		LoadDouble(sv);
+//Узлы, владеющие строками
+struct NodeFactory {
+	using NodeType = Node;
+	using ArrayType = Array;
+	using DictType = Dict;
+	using StringType = std::string;
+
+	StringType MakeString(std::string_view raw) {
+		return std::string{ raw };
 	}
-	if (count != sv.size()) {
-		throw json::ParsingError("Undefined Node type");
+	StringType MakeString(std::string&& decoded) {
+		return std::move(decoded);
 	}
-	return Node(value);
-}
+};
 
-Node LoadDouble(std::string_view sv) {
-	size_t count = 0;
-	double value = 0;
-	try {
-		value = std::stod(std::string{ sv }, &count);
-	} catch (std::invalid_argument& e) {
-		throw json::ParsingError(e.what());
-	} catch (std::out_of_range& e) {
-		throw json::ParsingError(e.what());
-	}
-	if (count != sv.size()) {
-		throw json::ParsingError("Undefined Node type");
+//Узлы, ссылающиеся на разбираемый текст
+struct ViewNodeFactory {
+	using NodeType = ViewNode;
+	using ArrayType = ViewArray;
+	using DictType = ViewDict;
+	using StringType = std::string_view;
+
+	std::deque<std::string>& decoded_strings;
+
+	StringType MakeString(std::string_view raw) {
+		return raw;
+	}
+	StringType MakeString(std::string&& decoded) {
+		return decoded_strings.emplace_back(std::move(decoded));
 	}
-	return Node(value);
+};
+
+//Разбор за один проход: курсор только продвигается вперед,
+//значения создаются на месте и перемещаются в родительский узел.
+//Типы узлов и способ хранения строк задает Factory
+template <typename Factory>
+class Parser {
+	using NodeType = typename Factory::NodeType;
+	using StringType = typename Factory::StringType;
+
+public:
+	Parser(std::string_view text, Factory factory)
+		: text_(text)
+		, factory_(std::move(factory)) {}
+
+	//Разбирает значение, после которого допустимы только пробельные символы
+	NodeType ParseDocument() {
+		NodeType root = ParseValue();
+		SkipSpaces();
+		if (pos_ != text_.size()) {
+			throw json::ParsingError("Unexpected characters after value");
+		}
+		return root;
+	}
+
+private:
+	NodeType ParseValue() {
+		SkipSpaces();
+		switch (Peek()) {
+		case '{':
+			return ParseDict();
+		case '[':
+			return ParseArray();
+		case '\"':
+			return NodeType(ParseString());
+		case 'n':
+			ParseLiteral("null"sv);
+			return NodeType();
+		case 't':
+			ParseLiteral("true"sv);
+			return NodeType(true);
+		case 'f':
+			ParseLiteral("false"sv);
+			return NodeType(false);
+		default:
+			return ParseNumber();
+		}
+	}
+
+	NodeType ParseDict() {
+		typename Factory::DictType result;
+		++pos_;
+		SkipSpaces();
+		if (Peek() == '}') {
+			++pos_;
+			return NodeType(std::move(result));
+		}
+		while (true) {
+			SkipSpaces();
+			if (Peek() != '\"') {
+				throw json::ParsingError("Incorrect Dictionary");
+			}
+			StringType key = ParseString();
+			SkipSpaces();
+			Expect(':');
+			result.emplace(std::move(key), ParseValue());
+			SkipSpaces();
+			if (Peek() == '}') {
+				++pos_;
+				return NodeType(std::move(result));
+			}
+			Expect(',');
+		}
+	}
+
+	NodeType ParseArray() {
+		typename Factory::ArrayType result;
+		++pos_;
+		SkipSpaces();
+		if (Peek() == ']') {
+			++pos_;
+			return NodeType(std::move(result));
+		}
+		while (true) {
+			result.push_back(ParseValue());
+			SkipSpaces();
+			if (Peek() == ']') {
+				++pos_;
+				return NodeType(std::move(result));
+			}
+			Expect(',');
+		}
+	}
+
+	//Строка без кавычек с раскрытыми escape-последовательностями.
+	//Строка без них передается фабрике как часть текста
+	StringType ParseString() {
+		++pos_;
+		size_t end = text_.find_first_of("\"\\"sv, pos_);
+		if (end != std::string_view::npos && text_[end] == '\"') {
+			const std::string_view raw = text_.substr(pos_, end - pos_);
+			pos_ = end + 1;
+			return factory_.MakeString(raw);
+		}
+		std::string result;
+		while (true) {
+			if (end == std::string_view::npos || (text_[end] == '\\' && end + 1 == text_.size())) {
+				throw json::ParsingError("Unterminated string");
+			}
+			result.append(text_.substr(pos_, end - pos_));
+			if (text_[end] == '\"') {
+				pos_ = end + 1;
+				return factory_.MakeString(std::move(result));
+			}
+			result += helpers::UnshildedChar(text_[end + 1]);
+			pos_ = end + 2;
+			end = text_.find_first_of("\"\\"sv, pos_);
+		}
+	}
+
+	//Целое число, если оно помещается в int, иначе число с плавающей точкой
+	NodeType ParseNumber() {
+		const size_t begin = pos_;
+		while (pos_ < text_.size() && NUMBER_CHARS.find(text_[pos_]) != std::string_view::npos) {
+			++pos_;
+		}
+		return std::visit([](auto value) { return NodeType(value); },
+			ReadNumber(text_.substr(begin, pos_ - begin)));
+	}
+
+	void ParseLiteral(std::string_view literal) {
+		if (text_.substr(pos_, literal.size()) != literal) {
+			throw json::ParsingError("Undefined Node type");
+		}
+		pos_ += literal.size();
+	}
+
+	void SkipSpaces() {
+		while (pos_ < text_.size() && SPACES.find(text_[pos_]) != std::string_view::npos) {
+			++pos_;
+		}
+	}
+
+	char Peek() const {
+		if (pos_ == text_.size()) {
+			throw json::ParsingError("Unexpected end of input");
+		}
+		return text_[pos_];
+	}
+
+	void Expect(char c) {
+		if (Peek() != c) {
+			throw json::ParsingError("Expected '"s + c + "'"s);
+		}
+		++pos_;
+	}
+
+	std::string_view text_;
+	size_t pos_ = 0;
+	Factory factory_;
+};
+
+//Разбор потока за один проход с вызовом обработчика вместо построения узлов.
+//Символы читаются из буфера потока по одному, поэтому разбор идет по мере поступления данных.
+//Строки и числа накапливаются в буферах, которые переиспользуются между значениями
+class EventParser {
+	using Traits = std::char_traits<char>;
+
+public:
+	EventParser(std::streambuf& input, EventHandler& handler)
+		: input_(input)
+		, handler_(handler) {}
+
+	//Разбирает значение, после которого допустимы только пробельные символы
+	void ParseDocument() {
+		ParseValue();
+		SkipSpaces();
+		if (!Traits::eq_int_type(input_.sgetc(), Traits::eof())) {
+			throw json::ParsingError("Unexpected characters after value");
+		}
+	}
+
+private:
+	void ParseValue() {
+		SkipSpaces();
+		switch (Peek()) {
+		case '{':
+			ParseDict();
+			return;
+		case '[':
+			ParseArray();
+			return;
+		case '\"':
+			handler_.String(ParseString());
+			return;
+		case 'n':
+			ParseLiteral("null"sv);
+			handler_.Null();
+			return;
+		case 't':
+			ParseLiteral("true"sv);
+			handler_.Bool(true);
+			return;
+		case 'f':
+			ParseLiteral("false"sv);
+			handler_.Bool(false);
+			return;
+		default:
+			ParseNumber();
+			return;
+		}
+	}
+
+	void ParseDict() {
+		input_.sbumpc();
+		handler_.StartDict();
+		SkipSpaces();
+		if (Peek() == '}') {
+			input_.sbumpc();
+			handler_.EndDict();
+			return;
+		}
+		while (true) {
+			SkipSpaces();
+			if (Peek() != '\"') {
+				throw json::ParsingError("Incorrect Dictionary");
+			}
+			handler_.Key(ParseString());
+			SkipSpaces();
+			Expect(':');
+			ParseValue();
+			SkipSpaces();
+			if (Peek() == '}') {
+				input_.sbumpc();
+				handler_.EndDict();
+				return;
+			}
+			Expect(',');
+		}
+	}
+
+	void ParseArray() {
+		input_.sbumpc();
+		handler_.StartArray();
+		SkipSpaces();
+		if (Peek() == ']') {
+			input_.sbumpc();
+			handler_.EndArray();
+			return;
+		}
+		while (true) {
+			ParseValue();
+			SkipSpaces();
+			if (Peek() == ']') {
+				input_.sbumpc();
+				handler_.EndArray();
+				return;
+			}
+			Expect(',');
+		}
+	}
+
+	//Строка без кавычек с раскрытыми escape-последовательностями,
+	//действительна до разбора следующей строки
+	std::string_view ParseString() {
+		input_.sbumpc();
+		string_buffer_.clear();
+		while (true) {
+			Traits::int_type c = input_.sbumpc();
+			if (Traits::eq_int_type(c, Traits::eof())) {
+				throw json::ParsingError("Unterminated string");
+			}
+			if (Traits::to_char_type(c) == '\"') {
+				return string_buffer_;
+			}
+			if (Traits::to_char_type(c) == '\\') {
+				c = input_.sbumpc();
+				if (Traits::eq_int_type(c, Traits::eof())) {
+					throw json::ParsingError("Unterminated string");
+				}
+				string_buffer_ += helpers::UnshildedChar(Traits::to_char_type(c));
+				continue;
+			}
+			string_buffer_ += Traits::to_char_type(c);
+		}
+	}
+
+	void ParseNumber() {
+		number_buffer_.clear();
+		for (Traits::int_type c = input_.sgetc(); !Traits::eq_int_type(c, Traits::eof())
+			&& NUMBER_CHARS.find(Traits::to_char_type(c)) != std::string_view::npos; c = input_.snextc()) {
+			number_buffer_ += Traits::to_char_type(c);
+		}
+		const auto value = ReadNumber(number_buffer_);
+		if (std::holds_alternative<int>(value)) {
+			handler_.Int(std::get<int>(value));
+		} else {
+			handler_.Double(std::get<double>(value));
+		}
+	}
+
+	void ParseLiteral(std::string_view literal) {
+		for (const char c : literal) {
+			if (!Traits::eq_int_type(input_.sbumpc(), Traits::to_int_type(c))) {
+				throw json::ParsingError("Undefined Node type");
+			}
+		}
+	}
+
+	void SkipSpaces() {
+		for (Traits::int_type c = input_.sgetc(); !Traits::eq_int_type(c, Traits::eof())
+			&& SPACES.find(Traits::to_char_type(c)) != std::string_view::npos; c = input_.snextc()) {
+		}
+	}
+
+	char Peek() {
+		const Traits::int_type c = input_.sgetc();
+		if (Traits::eq_int_type(c, Traits::eof())) {
+			throw json::ParsingError("Unexpected end of input");
+		}
+		return Traits::to_char_type(c);
+	}
+
+	void Expect(char c) {
+		if (Peek() != c) {
+			throw json::ParsingError("Expected '"s + c + "'"s);
+		}
+		input_.sbumpc();
+	}
+
+	std::streambuf& input_;
+	EventHandler& handler_;
+	std::string string_buffer_;
+	std::string number_buffer_;
+};
+
+}//end namespace
+
+Node LoadNode(std::string_view str) {
+	return Parser(str, NodeFactory{}).ParseDocument();
+}
+
+ViewNode LoadViewNode(std::string_view str, std::deque<std::string>& decoded_strings) {
+	return Parser(str, ViewNodeFactory{ decoded_strings }).ParseDocument();
 }
 
 namespace helpers {
@@ -413,94 +847,15 @@ char ShieldedChar(char c) {
 	}
 }
 
-size_t FindNextUnshildedQuote(std::string_view sv, size_t from) {
-	size_t end = from + 1;
-	while (end != sv.size() && !(sv[end] == '\"' && sv[end - 1] != '\\')) {
-		++end;
-	}
-	return end == sv.size() ? std::string::npos : end;
-}
-
-size_t FindValueBegin(std::string_view sv, size_t from) {
-	if (from >= sv.size()) {
-		return std::string::npos;
-	}
-	size_t begin = sv.find_first_not_of(SPACES, from);
-	if (begin == std::string::npos) {
-		return std::string::npos;
-	}
-	if (sv[begin] == ':' || sv[begin] == ',') {
-		return sv.find_first_not_of(SPACES, begin + 1);
-	}
-	return begin;
-}
-
-size_t FindValueEnd(std::string_view sv, size_t from) {
-	if (from >= sv.size()) {
-		return std::string::npos;
-	}
-	const char start_char = sv[from];
-	size_t end = from;
-	if (start_char == '{' || start_char == '[') {
-		const char end_char = start_char == '{' ? '}' : ']';
-		const std::string_view braces = (start_char == '{') ? "{}\""sv : "[]\""sv;
-		size_t open_brace_count = 1, close_brace_count = 0;
-		bool is_quote_open = false;
-		while (open_brace_count != close_brace_count) {
-			end = sv.find_first_of(braces, end + 1);
-			if (sv[end] == start_char && !is_quote_open) {
-				++open_brace_count;
-			} else if (sv[end] == end_char && !is_quote_open) {
-				++close_brace_count;
-			} else if (sv[end] == '\"' && sv[end - 1] != '\\') {
-				is_quote_open = !is_quote_open;
-			}
-			if (end == std::string::npos) {
-				throw json::ParsingError("Incorrect Array/Dictionary");
-			}
-		}
-		return end + 1;
-	}
-	if (start_char == '\"') {
-		end = FindNextUnshildedQuote(sv, from);
-	}
-	if (end == std::string::npos) {
-		throw json::ParsingError("Incorrect Array");
-	}
-	end = sv.find_first_of(',', end);
-	return end == std::string::npos ? sv.size() : end;
-}
+}//end namespace helpers
 
-size_t FindKeyBegin(std::string_view sv, size_t from) {
-	if (from >= sv.size()) {
-		return std::string::npos;
-	}
-	if (sv[from] == ',') {
-		++from;
-	}
-	size_t key_begin = sv.find_first_not_of(SPACES, from);
-	if (key_begin == std::string::npos) {
-		return std::string::npos;
-	}
-	if (sv[key_begin] != '\"') {
-		throw json::ParsingError("Incorrect Dictionary");
-	}
-	return key_begin + 1;
-}
+}//end namespace parsing
 
-size_t FindkeyEnd(std::string_view sv, size_t key_begin) {
-	if (key_begin == std::string::npos) {
-		return  key_begin;
-	}
-	size_t key_end = FindNextUnshildedQuote(sv, key_begin);
-	if (key_end == std::string::npos) {
-		throw json::ParsingError("Incorrect Dictionary");
+void Parse(std::istream& input, EventHandler& handler) {
+	if (input.rdbuf() == nullptr) {
+		throw json::ParsingError("Empty File");
 	}
-	return key_end;
+	parsing::EventParser(*input.rdbuf(), handler).ParseDocument();
 }
 
-}//end namespace helpers
-
-}//end namespace parsing
-
 }  // namespace json
\ No newline at end of file
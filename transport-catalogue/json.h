@@ -2,9 +2,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <exception>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -84,6 +87,110 @@ Document Load(std::istream& input);
 
 void Print(const Document& doc, std::ostream& output);
 
+class ViewNode;
+
+//Словарь и массив узлов, строки которых ссылаются на текст документа
+using ViewDict = std::map<std::string_view, ViewNode>;
+
+using ViewArray = std::vector<ViewNode>;
+
+//Узел только для чтения: строки и ключи словарей не владеют памятью
+//и действительны, пока жив документ ViewDocument, которому принадлежит узел
+class ViewNode final
+	: private std::variant<std::nullptr_t, ViewArray, ViewDict, bool, int, double, std::string_view> {
+public:
+	using variant::variant;
+
+	bool IsArray() const;
+	bool IsBool() const;
+	bool IsDouble() const;
+	bool IsInt() const;
+	bool IsNull() const;
+	bool IsMap() const;
+	bool IsPureDouble() const;
+	bool IsString() const;
+	const ViewArray& AsArray() const;
+	bool AsBool() const;
+	int AsInt() const;
+	double AsDouble() const;
+	const ViewDict& AsMap() const;
+	std::string_view AsString() const;
+
+	using Value = variant;
+	Value& GetValue();
+};
+
+//Документ, который хранит исходный текст и ссылается на него из узлов без копирования строк.
+//Раскрываются и хранятся отдельно только строки с escape-последовательностями
+class ViewDocument {
+public:
+	explicit ViewDocument(std::string text);
+
+	//Документ из узлов, строки которых ссылаются на элементы strings
+	ViewDocument(std::deque<std::string> strings, ViewNode root);
+
+	const ViewNode& GetRoot() const;
+
+	//Память текста и раскрытых строк в байтах
+	size_t GetStringsMemoryUsage() const;
+
+private:
+	//Текст в отдельном блоке: его адрес не меняется при перемещении документа
+	std::unique_ptr<const std::string> text_;
+	std::deque<std::string> decoded_strings_;
+	ViewNode root_;
+};
+
+//Загружает документ без копирования строк из потока ввода
+ViewDocument LoadView(std::istream& input);
+
+//Обработчик событий потокового разбора. Строки и ключи действительны только во время вызова
+class EventHandler {
+public:
+	virtual void StartDict() = 0;
+	virtual void Key(std::string_view key) = 0;
+	virtual void EndDict() = 0;
+	virtual void StartArray() = 0;
+	virtual void EndArray() = 0;
+	virtual void Null() = 0;
+	virtual void Bool(bool value) = 0;
+	virtual void Int(int value) = 0;
+	virtual void Double(double value) = 0;
+	virtual void String(std::string_view value) = 0;
+	virtual ~EventHandler() = default;
+};
+
+//Разбирает JSON по мере чтения из потока и сообщает обработчику о каждом значении,
+//не строя документ
+void Parse(std::istream& input, EventHandler& handler);
+
+//Обработчик, собирающий документ из событий разбора. Строки копируются в документ
+class ViewDocumentBuilder final : public EventHandler {
+public:
+	void StartDict() override;
+	void Key(std::string_view key) override;
+	void EndDict() override;
+	void StartArray() override;
+	void EndArray() override;
+	void Null() override;
+	void Bool(bool value) override;
+	void Int(int value) override;
+	void Double(double value) override;
+	void String(std::string_view value) override;
+
+	//Документ из полученных событий. Только после завершения корневого значения
+	ViewDocument Build();
+
+private:
+	void AddValue(ViewNode value);
+
+	std::deque<std::string> strings_;
+	//Незавершенные словари и массивы и ключи незавершенных словарей
+	std::vector<ViewNode> stack_;
+	std::vector<std::string_view> keys_;
+	std::optional<ViewNode> root_;
+};
+
 namespace detail {
 
 // Контекст вывода, хранит ссылку на поток вывода и текущий отсуп
@@ -122,17 +229,12 @@ void PrintWithEscapeSeq(const std::string& str, std::ostream& out);
 //Функции парсинга строки и формирования Node
 namespace parsing{
 
+//Разбирает текст JSON за один проход
 Node LoadNode(std::string_view str);
 
-Node LoadDict(std::string_view str);
-
-Node LoadArray(std::string_view str);
-
-Node LoadString(std::string_view str);
-
-Node LoadInt(std::string_view str);
-
-Node LoadDouble(std::string_view str);
+//Разбирает текст JSON за один проход в узлы, ссылающиеся на str.
+//Строки с escape-последовательностями раскрываются в decoded_strings
+ViewNode LoadViewNode(std::string_view str, std::deque<std::string>& decoded_strings);
 
 //Фунцкии-помощники парсинга
 namespace helpers {
@@ -141,18 +243,8 @@ char UnshildedChar(char c);
 
 char ShieldedChar(char c);
 
-size_t FindNextUnshildedQuote(std::string_view sv, size_t from = 0);
-
-size_t FindValueBegin(std::string_view sv, size_t from = 0);
-
-size_t FindValueEnd(std::string_view sv, size_t from = 0);
-
-size_t FindKeyBegin(std::string_view sv, size_t from = 0);
-
-size_t FindkeyEnd(std::string_view sv, size_t key_begin = 0);
+}//end namespace helpers
 
 }//end namespace parsing
 
-}//end namespace helpers
-
 }//end namespace json
\ No newline at end of file
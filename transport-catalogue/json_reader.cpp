@@ -1,4 +1,5 @@
 #include "json_reader.h"
+#include "parallel_for.h"
 
 namespace json_reader {
 
@@ -16,69 +17,37 @@ static const std::unordered_map<std::string_view, RequestType> REQUESTS_LIST{
 	{"Stop"sv, RequestType::STOP_STAT},
 	{"Bus"sv, RequestType::BUS_STAT},
 	{"Map"sv, RequestType::MAP},
-	{"Route"sv, RequestType::ROUTE}
+	{"Route"sv, RequestType::ROUTE},
+	{"CommonBuses"sv, RequestType::COMMON_BUSES},
+	{"NearestStops"sv, RequestType::NEAREST_STOPS},
+	{"StopsInBox"sv, RequestType::STOPS_IN_BOX},
+	{"Suggest"sv, RequestType::SUGGEST},
+	{"AllBuses"sv, RequestType::ALL_BUSES},
+	{"AllStops"sv, RequestType::ALL_STOPS}
 };
 
+//Элементы ответов AllBuses и AllStops формируются партиями такого размера,
+//не меньше MIN_BULK_ITEMS_PER_THREAD элементов на поток
+static const size_t BULK_BATCH_SIZE = 4096;
+static const size_t MIN_BULK_ITEMS_PER_THREAD = 256;
+
 using namespace json;
 using transport_catalogue::TransportCatalogue;
 using renderer::RenderSettings;
 using transport_router::RoutingSettings;
 
-Document ReadFromJSON(std::istream& input) {
-	return { Load(input) };
+ViewDocument ReadFromJSON(std::istream& input) {
+	return LoadView(input);
 }
 
-TransportCatalogue ProcessBaseRequests(const Document& raw_requests) {
-	assert(raw_requests.GetRoot().IsMap());
-	TransportCatalogue t_catalogue;
-	if (!raw_requests.GetRoot().AsMap().count(BASE_REQUESTS)) {
-		return t_catalogue;
-	}
-	const auto& requests = raw_requests.GetRoot().AsMap().at(BASE_REQUESTS).AsArray();
-	if (requests.empty()) {
-		return t_catalogue;
-	}
-	std::vector<detail::AddStopRequest> add_stop_requests;
-	std::vector<detail::AddBusRequest> add_bus_requests;
-	for (const Node& request : requests) {
-		if (request.AsMap().at("type"s) == "Stop"s) {
-			detail::AddStopRequest add_request;
-			add_request.name = request.AsMap().at("name"s).AsString();
-			add_request.latitude = request.AsMap().at("latitude"s).AsDouble();
-			add_request.longitude = request.AsMap().at("longitude"s).AsDouble();
-			for ( const auto& [name, distance] : request.AsMap().at("road_distances"s).AsMap() ) {
-				add_request.name_to_dist.insert({ name, distance.AsInt() });
-			}
-			add_stop_requests.push_back(std::move(add_request));
-		} else if (request.AsMap().at("type"s) == "Bus"s) {
-			detail::AddBusRequest add_request;
-			add_request.name = request.AsMap().at("name"s).AsString();
-			add_request.is_roundtrip = request.AsMap().at("is_roundtrip"s).AsBool();
-			for ( const Node& bus : request.AsMap().at("stops"s).AsArray() ) {
-				add_request.stops.push_back(bus.AsString());
-			}
-			add_bus_requests.push_back(std::move(add_request));
-		} else {
-			assert(false);
-		}
-	}
-	for ( const auto& add_stop_query : add_stop_requests ) {
-		t_catalogue.AddStop(add_stop_query.name,
-			{ add_stop_query.latitude, add_stop_query.longitude });
-	}
-	for ( const auto& add_stop_query : add_stop_requests ) {
-		t_catalogue.SetStopDistances(add_stop_query.name,
-			add_stop_query.name_to_dist);
-	}
-	for ( const auto& add_bus_query : add_bus_requests ) {
-		t_catalogue.AddBus(add_bus_query.name,
-			add_bus_query.stops, add_bus_query.is_roundtrip);
-	}
-	return t_catalogue;
+BaseInput ReadBaseInput(std::istream& input) {
+	detail::BaseRequestsHandler handler;
+	json::Parse(input, handler);
+	return { handler.BuildCatalogue(), handler.BuildSettings() };
 }
 
 void ProcessStatRequests(const RequestHandler& req_handler,
-	const Document& raw_requests, std::ostream& output) {
+	const ViewDocument& raw_requests, std::ostream& output) {
 	using detail::RequestType;
 	assert(raw_requests.GetRoot().IsMap());
 	if ( !raw_requests.GetRoot().AsMap().count(STAT_REQUESTS) ) {
@@ -87,26 +56,62 @@ void ProcessStatRequests(const RequestHandler& req_handler,
 	const auto& requests = raw_requests.GetRoot().AsMap().at(STAT_REQUESTS).AsArray();
 	if ( requests.empty() ) { return; }
 	std::vector<detail::StatRequest> stat_requests;
-	for ( const Node& request : requests ) {
+	for ( const ViewNode& request : requests ) {
 		detail::StatRequest stat_request;
-		const std::string& request_name = request.AsMap().at("type"s).AsString();
+		const std::string_view request_name = request.AsMap().at("type"s).AsString();
 		assert(REQUESTS_LIST.count(request_name) > 0);
 		stat_request.type = REQUESTS_LIST.at(request_name);
 		stat_request.id = request.AsMap().at("id"s).AsInt();
 		if (stat_request.type == RequestType::STOP_STAT || stat_request.type == RequestType::BUS_STAT) {
 			stat_request.request_data = request.AsMap().at("name"s).AsString();
 		}
-		if (stat_request.type == RequestType::ROUTE) {
+		if (stat_request.type == RequestType::ROUTE || stat_request.type == RequestType::COMMON_BUSES) {
 			std::string_view from, to;
 			from = request.AsMap().at("from"s).AsString();
 			to = request.AsMap().at("to"s).AsString();
 			stat_request.request_data = std::pair{ from, to };
 		}
+		if (stat_request.type == RequestType::NEAREST_STOPS) {
+			const auto& params = request.AsMap();
+			detail::NearestStopsQuery query;
+			query.point = { params.at("latitude"s).AsDouble(), params.at("longitude"s).AsDouble() };
+			if (params.count("count"s)) {
+				query.count = params.at("count"s).AsInt();
+			}
+			if (params.count("radius"s)) {
+				query.radius = params.at("radius"s).AsDouble();
+			}
+			stat_request.request_data = query;
+		}
+		if (stat_request.type == RequestType::STOPS_IN_BOX) {
+			const auto& params = request.AsMap();
+			detail::BoxQuery query;
+			query.min = { params.at("min_latitude"s).AsDouble(), params.at("min_longitude"s).AsDouble() };
+			query.max = { params.at("max_latitude"s).AsDouble(), params.at("max_longitude"s).AsDouble() };
+			stat_request.request_data = query;
+		}
+		if (stat_request.type == RequestType::SUGGEST) {
+			const auto& params = request.AsMap();
+			detail::SuggestQuery query;
+			query.prefix = params.at("prefix"s).AsString();
+			if (params.count("limit"s)) {
+				query.limit = params.at("limit"s).AsInt();
+			}
+			stat_request.request_data = query;
+		}
 		stat_requests.push_back(std::move(stat_request));
 	}
-	Builder stats;
-	stats.StartArray();
+	//Ответы выводятся по мере готовности, в том же виде, что и массив json::Print
+	const json::detail::PrintContext context{ output };
+	output << '[' << '\n';
+	bool is_first = true;
 	for ( const auto& stat_request : stat_requests ) {
+		if ( !is_first ) {
+			output << ',' << '\n';
+		}
+		is_first = false;
+		context.Indented().PrintIndent();
+		Builder stats;
 		switch ( stat_request.type ) {
 		case RequestType::STOP_STAT:
 			detail::ProcessStopStatRequest(req_handler, stats, stat_request);
@@ -120,16 +125,34 @@ void ProcessStatRequests(const RequestHandler& req_handler,
 		case RequestType::ROUTE:
 			detail::ProcessRouteRequest(req_handler, stats, stat_request);
 			break;
+		case RequestType::COMMON_BUSES:
+			detail::ProcessCommonBusesRequest(req_handler, stats, stat_request);
+			break;
+		case RequestType::NEAREST_STOPS:
+			detail::ProcessNearestStopsRequest(req_handler, stats, stat_request);
+			break;
+		case RequestType::STOPS_IN_BOX:
+			detail::ProcessStopsInBoxRequest(req_handler, stats, stat_request);
+			break;
+		case RequestType::SUGGEST:
+			detail::ProcessSuggestRequest(req_handler, stats, stat_request);
+			break;
+		case RequestType::ALL_BUSES:
+			detail::ProcessAllBusesRequest(req_handler, stat_request, context.Indented());
+			continue;
+		case RequestType::ALL_STOPS:
+			detail::ProcessAllStopsRequest(req_handler, stat_request, context.Indented());
+			continue;
 		default:
 			assert(false);
 			break;
 		}
+		stats.Build().PrintValue(context.Indented());
 	}
-	stats.EndArray();
-	Print(Document{ Node{ stats.Build()} }, output);
+	output << '\n' << ']';
 }
 
-RenderSettings ProcessRenderSettings(const Document& raw_requests) {
+RenderSettings ProcessRenderSettings(const ViewDocument& raw_requests) {
 	RenderSettings result;
 	assert(raw_requests.GetRoot().IsMap());
 	if ( !raw_requests.GetRoot().AsMap().count(RENDER_SETTINGS) ) {
@@ -169,7 +192,7 @@ RenderSettings ProcessRenderSettings(const Document& raw_requests) {
 	return result;
 }
 
-RoutingSettings ProcessRoutingSettings(const Document& raw_requests) {
+RoutingSettings ProcessRoutingSettings(const ViewDocument& raw_requests) {
 	assert(raw_requests.GetRoot().IsMap());
 	if ( !raw_requests.GetRoot().AsMap().count(ROUTING_SETTINGS) ) {
 		return {};
@@ -180,7 +203,7 @@ RoutingSettings ProcessRoutingSettings(const Document& raw_requests) {
 		.SetBusVelocity(settings.at("bus_velocity"s).AsDouble());
 }
 
-std::filesystem::path ProcessPath(const json::Document& raw_requests) {
+std::filesystem::path ProcessPath(const ViewDocument& raw_requests) {
 	assert(raw_requests.GetRoot().IsMap());
 	if (!raw_requests.GetRoot().AsMap().count(SERIALIZATION_SETTINGS)) {
 		return {};
@@ -193,10 +216,153 @@ std::filesystem::path ProcessPath(const json::Document& raw_requests) {
 
 namespace detail {
 
-svg::Color GetColor(const Node& color) {
+void BaseRequestsHandler::StartDict() {
+	++depth_;
+	if (in_base_requests_) {
+		if (depth_ == REQUEST_DEPTH) {
+			kind_ = RequestKind::UNKNOWN;
+			add_stop_request_ = {};
+			add_bus_request_ = {};
+		}
+		return;
+	}
+	settings_.StartDict();
+}
+
+void BaseRequestsHandler::Key(std::string_view key) {
+	if (in_base_requests_) {
+		if (depth_ == REQUEST_DEPTH) {
+			key_ = key;
+		} else if (depth_ == REQUEST_FIELD_DEPTH) {
+			distance_to_ = names_.Intern(key);
+		}
+		return;
+	}
+	if (depth_ == 1) {
+		is_base_requests_key_ = key == BASE_REQUESTS;
+		if (is_base_requests_key_) {
+			return;
+		}
+	}
+	settings_.Key(key);
+}
+
+void BaseRequestsHandler::EndDict() {
+	if (in_base_requests_) {
+		if (depth_ == REQUEST_DEPTH) {
+			FinishRequest();
+		}
+	} else {
+		settings_.EndDict();
+	}
+	--depth_;
+}
+
+void BaseRequestsHandler::StartArray() {
+	if (depth_ == 1 && is_base_requests_key_) {
+		in_base_requests_ = true;
+	}
+	++depth_;
+	if (!in_base_requests_) {
+		settings_.StartArray();
+	}
+}
+
+void BaseRequestsHandler::EndArray() {
+	if (!in_base_requests_) {
+		settings_.EndArray();
+	} else if (depth_ == REQUEST_DEPTH - 1) {
+		in_base_requests_ = false;
+		is_base_requests_key_ = false;
+	}
+	--depth_;
+}
+
+void BaseRequestsHandler::Null() {
+	if (!in_base_requests_) {
+		settings_.Null();
+	}
+}
+
+void BaseRequestsHandler::Bool(bool value) {
+	if (!in_base_requests_) {
+		settings_.Bool(value);
+	} else if (depth_ == REQUEST_DEPTH && key_ == "is_roundtrip"sv) {
+		add_bus_request_.is_roundtrip = value;
+	}
+}
+
+void BaseRequestsHandler::Int(int value) {
+	if (!in_base_requests_) {
+		settings_.Int(value);
+	} else if (depth_ == REQUEST_FIELD_DEPTH) {
+		add_stop_request_.name_to_dist.insert({ distance_to_, value });
+	} else {
+		Double(value);
+	}
+}
+
+void BaseRequestsHandler::Double(double value) {
+	if (!in_base_requests_) {
+		settings_.Double(value);
+	} else if (depth_ == REQUEST_DEPTH && key_ == "latitude"sv) {
+		add_stop_request_.latitude = value;
+	} else if (depth_ == REQUEST_DEPTH && key_ == "longitude"sv) {
+		add_stop_request_.longitude = value;
+	}
+}
+
+void BaseRequestsHandler::String(std::string_view value) {
+	if (!in_base_requests_) {
+		settings_.String(value);
+	} else if (depth_ == REQUEST_FIELD_DEPTH) {
+		add_bus_request_.stops.push_back(names_.Intern(value));
+	} else if (depth_ == REQUEST_DEPTH && key_ == "type"sv) {
+		kind_ = value == "Stop"sv ? RequestKind::STOP
+			: value == "Bus"sv ? RequestKind::BUS
+			: RequestKind::UNKNOWN;
+	} else if (depth_ == REQUEST_DEPTH && key_ == "name"sv) {
+		add_stop_request_.name = add_bus_request_.name = names_.Intern(value);
+	}
+}
+
+TransportCatalogue BaseRequestsHandler::BuildCatalogue() {
+	TransportCatalogue t_catalogue;
+	transport_catalogue::CatalogueData data;
+	data.stops.reserve(add_stop_requests_.size());
+	for ( auto& add_stop_query : add_stop_requests_ ) {
+		data.stops.push_back({ add_stop_query.name,
+			{ add_stop_query.latitude, add_stop_query.longitude },
+			std::move(add_stop_query.name_to_dist) });
+	}
+	data.buses.reserve(add_bus_requests_.size());
+	for ( auto& add_bus_query : add_bus_requests_ ) {
+		data.buses.push_back({ add_bus_query.name,
+			std::move(add_bus_query.stops), add_bus_query.is_roundtrip });
+	}
+	t_catalogue.AddBulk(data);
+	t_catalogue.Finalize();
+	return t_catalogue;
+}
+
+json::ViewDocument BaseRequestsHandler::BuildSettings() {
+	return settings_.Build();
+}
+
+void BaseRequestsHandler::FinishRequest() {
+	if (kind_ == RequestKind::STOP) {
+		add_stop_requests_.push_back(std::move(add_stop_request_));
+	} else if (kind_ == RequestKind::BUS) {
+		add_bus_requests_.push_back(std::move(add_bus_request_));
+	} else {
+		assert(false);
+	}
+}
+
+svg::Color GetColor(const ViewNode& color) {
 	svg::Color result;
 	if (color.IsString()) {
-		result = color.AsString();
+		result = std::string{ color.AsString() };
 	} else if ( color.IsArray() ) {
 		const int r = color.AsArray()[0].AsInt();
 		const int g = color.AsArray()[1].AsInt();
@@ -220,8 +386,8 @@ void ProcessStopStatRequest(const RequestHandler& req_handler, Builder& stats,
 	if ( stop_stat ) {
 		Builder buses;
 		buses.StartArray();
-		for ( const auto& bus : stop_stat->buses ) {
-			buses.Value(std::string{ bus });
+		for ( const auto bus : stop_stat->buses ) {
+			buses.Value(std::string{ req_handler.GetBusName(bus) });
 		}
 		buses.EndArray();
 		stats.StartDict()
@@ -295,14 +461,14 @@ void ProcessRouteRequest(const RequestHandler& req_handler, Builder& stats,
 		total_time += route_part.weight;
 		if (route_part.type == transport_router::TransportRouter::EdgeInfo::EdgeType::WAIT) {
 			stats.StartDict().
-				Key("stop_name"s).Value(route_part.stop_ptr->name)
+				Key("stop_name"s).Value(std::string{ route_part.stop_ptr->name })
 				.Key("time"s).Value(route_part.weight)
 				.Key("type"s).Value("Wait"s)
 				.EndDict();
 		}
 		if (route_part.type == transport_router::TransportRouter::EdgeInfo::EdgeType::BUS) {
 			stats.StartDict().
-				Key("bus"s).Value(route_part.bus_ptr->name)
+				Key("bus"s).Value(std::string{ route_part.bus_ptr->name })
 				.Key("span_count"s).Value(route_part.span_count)
 				.Key("time"s).Value(route_part.weight)
 				.Key("type"s).Value("Bus"s)
@@ -315,6 +481,172 @@ void ProcessRouteRequest(const RequestHandler& req_handler, Builder& stats,
 		.EndDict();
 }
 
+//stat_request.type == RequestType::COMMON_BUSES
+void ProcessCommonBusesRequest(const RequestHandler& req_handler, Builder& stats,
+	const detail::StatRequest& stat_request) {
+	const auto [from, to] = std::get<std::pair<std::string_view, std::string_view>>(stat_request.request_data);
+	auto common_buses = req_handler.GetCommonBuses(from, to);
+	if ( common_buses ) {
+		Builder buses;
+		buses.StartArray();
+		for ( const auto bus : *common_buses ) {
+			buses.Value(std::string{ req_handler.GetBusName(bus) });
+		}
+		buses.EndArray();
+		stats.StartDict()
+			.Key("buses"s).Value(buses.Build().AsArray())
+			.Key("request_id"s).Value(stat_request.id)
+			.EndDict();
+	} else {
+		stats.StartDict()
+			.Key("request_id"s).Value(stat_request.id)
+			.Key("error_message"s).Value("not found"s)
+			.EndDict();
+	}
+}
+
+//stat_request.type == RequestType::NEAREST_STOPS
+void ProcessNearestStopsRequest(const RequestHandler& req_handler, Builder& stats,
+	const detail::StatRequest& stat_request) {
+	const auto& query = std::get<detail::NearestStopsQuery>(stat_request.request_data);
+	const auto nearest = req_handler.GetNearestStops(query.point,
+		static_cast<size_t>(std::max(0, query.count)), query.radius);
+	stats.StartDict()
+		.Key("request_id"s).Value(stat_request.id)
+		.Key("stops"s).StartArray();
+	for (const auto& [stop, distance] : nearest) {
+		stats.StartDict()
+			.Key("distance"s).Value(distance)
+			.Key("stop_name"s).Value(std::string{ stop->name })
+			.EndDict();
+	}
+	stats.EndArray().EndDict();
+}
+
+//stat_request.type == RequestType::STOPS_IN_BOX
+void ProcessStopsInBoxRequest(const RequestHandler& req_handler, Builder& stats,
+	const detail::StatRequest& stat_request) {
+	const auto& query = std::get<detail::BoxQuery>(stat_request.request_data);
+	stats.StartDict()
+		.Key("request_id"s).Value(stat_request.id)
+		.Key("stops"s).StartArray();
+	for (const auto stop : req_handler.GetStopsInBox(query.min, query.max)) {
+		stats.Value(std::string{ stop->name });
+	}
+	stats.EndArray().EndDict();
+}
+
+//stat_request.type == RequestType::SUGGEST
+void ProcessSuggestRequest(const RequestHandler& req_handler, Builder& stats,
+	const detail::StatRequest& stat_request) {
+	const auto& query = std::get<detail::SuggestQuery>(stat_request.request_data);
+	const auto suggestions = req_handler.Suggest(query.prefix,
+		static_cast<size_t>(std::max(0, query.limit)));
+	stats.StartDict()
+		.Key("items"s).StartArray();
+	for (const auto& [name, kind] : suggestions) {
+		stats.StartDict()
+			.Key("name"s).Value(std::string{ name })
+			.Key("type"s).Value(kind == transport_catalogue::domain::PrefixIndex::Kind::STOP ? "Stop"s : "Bus"s)
+			.EndDict();
+	}
+	stats.EndArray()
+		.Key("request_id"s).Value(stat_request.id)
+		.EndDict();
+}
+
+namespace {
+
+//Выводит словарь из request_id и массива item_count элементов под ключом items_key.
+//Элементы партии строятся build_item и печатаются в строки параллельно,
+//затем строки выводятся в порядке элементов
+template <typename ItemBuilder>
+void StreamBulkResponse(int request_id, const std::string& items_key, size_t item_count,
+	ItemBuilder build_item, json::detail::PrintContext context) {
+	const auto print_request_id = [request_id, &context]() {
+		json::detail::PrintString("request_id"s, context.Indented());
+		context.out << request_id;
+	};
+	//Ключи словаря выводятся в порядке имен
+	const bool is_items_first = items_key < "request_id"s;
+	context.out << '{' << '\n';
+	if ( !is_items_first ) {
+		print_request_id();
+		context.out << ',' << '\n';
+	}
+	const auto items_context = context.Indented();
+	json::detail::PrintString(items_key, items_context);
+	context.out << '[' << '\n';
+	std::vector<std::string> printed_items;
+	for ( size_t batch_begin = 0; batch_begin < item_count; batch_begin += BULK_BATCH_SIZE ) {
+		const size_t batch_size = std::min(BULK_BATCH_SIZE, item_count - batch_begin);
+		printed_items.assign(batch_size, {});
+		transport_catalogue::detail::ParallelFor(batch_size, MIN_BULK_ITEMS_PER_THREAD,
+			[&build_item, &printed_items, &items_context, batch_begin](size_t i) {
+				std::ostringstream item_output;
+				const json::detail::PrintContext item_context{ item_output,
+					items_context.indent_step, items_context.indent + items_context.indent_step };
+				item_context.PrintIndent();
+				build_item(batch_begin + i).PrintValue(item_context);
+				printed_items[i] = item_output.str();
+			});
+		for ( size_t i = 0; i < batch_size; ++i ) {
+			if ( batch_begin + i > 0 ) {
+				context.out << ',' << '\n';
+			}
+			context.out << printed_items[i];
+		}
+	}
+	context.out << '\n';
+	items_context.PrintIndent();
+	context.out << ']';
+	if ( is_items_first ) {
+		context.out << ',' << '\n';
+		print_request_id();
+	}
+	context.out << '\n';
+	context.PrintIndent();
+	context.out << '}';
+}
+
+}//end namespace
+
+//stat_request.type == RequestType::ALL_BUSES
+void ProcessAllBusesRequest(const RequestHandler& req_handler, const detail::StatRequest& stat_request,
+	json::detail::PrintContext context) {
+	const auto& buses = req_handler.GetBusesByName();
+	StreamBulkResponse(stat_request.id, "buses"s, buses.size(), [&req_handler, &buses](size_t i) {
+		const auto bus_stat = req_handler.GetBusStat(buses[i]);
+		return Builder{}.StartDict()
+			.Key("curvature"s).Value(bus_stat.length_curv / bus_stat.length_geo)
+			.Key("name"s).Value(std::string{ bus_stat.name })
+			.Key("route_length"s).Value(bus_stat.length_curv)
+			.Key("stop_count"s).Value(static_cast<int>(bus_stat.stops_count))
+			.Key("unique_stop_count"s).Value(static_cast<int>(bus_stat.unique_stops_count))
+			.EndDict()
+			.Build();
+	}, context);
+}
+
+//stat_request.type == RequestType::ALL_STOPS
+void ProcessAllStopsRequest(const RequestHandler& req_handler, const detail::StatRequest& stat_request,
+	json::detail::PrintContext context) {
+	const auto stops = req_handler.GetStopsByName();
+	StreamBulkResponse(stat_request.id, "stops"s, stops.size(), [&req_handler, &stops](size_t i) {
+		const auto stop_stat = req_handler.GetStopStat(stops[i]);
+		Builder stat;
+		stat.StartDict()
+			.Key("buses"s).StartArray();
+		for ( const auto bus : stop_stat.buses ) {
+			stat.Value(std::string{ req_handler.GetBusName(bus) });
+		}
+		stat.EndArray()
+			.Key("name"s).Value(std::string{ stop_stat.name })
+			.EndDict();
+		return stat.Build();
+	}, context);
+}
+
 }//end namespace detail
 
 }//end namespace json_reader
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <cassert>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <optional>
 #include <string>
 #include <sstream>
@@ -21,23 +22,30 @@ namespace json_reader {
 
 using transport_catalogue::TransportCatalogue;
 
-json::Document ReadFromJSON(std::istream& input);
+json::ViewDocument ReadFromJSON(std::istream& input);
 
-// Обрабатывает запросы на добавление в базу
-TransportCatalogue ProcessBaseRequests(const json::Document& raw_requests);
+//Справочник из base_requests и документ с остальными разделами входных данных
+struct BaseInput {
+	TransportCatalogue catalogue;
+	json::ViewDocument settings;
+};
+
+//Читает входные данные make_base по мере поступления: запросы на добавление в базу
+//разбираются по событиям без построения документа, остальные разделы собираются в документ
+BaseInput ReadBaseInput(std::istream& input);
 
 //Обрабатывает запросы чтения и выводит результат в поток
 void ProcessStatRequests(const RequestHandler& req_handler,
-	const json::Document& raw_requests, std::ostream& output);
+	const json::ViewDocument& raw_requests, std::ostream& output);
 
 // Обрабатывает настройти рендера
-renderer::RenderSettings ProcessRenderSettings(const json::Document& raw_requests);
+renderer::RenderSettings ProcessRenderSettings(const json::ViewDocument& raw_requests);
 
 // Обрабатывает настройки маршрутизации
-transport_router::RoutingSettings ProcessRoutingSettings(const json::Document& raw_requests);
+transport_router::RoutingSettings ProcessRoutingSettings(const json::ViewDocument& raw_requests);
 
 // Обрабатывает путь к файлу
-std::filesystem::path ProcessPath(const json::Document& raw_requests);
+std::filesystem::path ProcessPath(const json::ViewDocument& raw_requests);
 
 namespace detail {
 
@@ -46,7 +54,13 @@ enum class RequestType {
 	STOP_STAT,
 	BUS_STAT,
 	MAP,
-	ROUTE
+	ROUTE,
+	COMMON_BUSES,
+	NEAREST_STOPS,
+	STOPS_IN_BOX,
+	SUGGEST,
+	ALL_BUSES,
+	ALL_STOPS
 };
 struct AddStopRequest {
 	std::string_view name;
@@ -59,16 +73,84 @@ struct AddBusRequest {
 	std::vector<std::string_view> stops;
 	bool is_roundtrip = false;
 };
+struct NearestStopsQuery {
+	transport_catalogue::geo::Coordinates point{};
+	int count = 1;
+	double radius = std::numeric_limits<double>::infinity();
+};
+struct BoxQuery {
+	transport_catalogue::geo::Coordinates min{};
+	transport_catalogue::geo::Coordinates max{};
+};
+struct SuggestQuery {
+	std::string_view prefix;
+	int limit = 10;
+};
 struct StatRequest {
 	int id = 0;
 	RequestType type{};
 	//std::string_view name;
-	std::variant<std::monostate, std::string_view, std::pair<std::string_view, std::string_view>>
-		request_data;
+	std::variant<std::monostate, std::string_view, std::pair<std::string_view, std::string_view>,
+		NearestStopsQuery, BoxQuery, SuggestQuery> request_data;
+};
+
+//Обработчик событий разбора входных данных make_base. Запросы из base_requests
+//сразу превращаются в AddStopRequest и AddBusRequest, остальные события
+//передаются в документ с настройками
+class BaseRequestsHandler final : public json::EventHandler {
+public:
+	void StartDict() override;
+	void Key(std::string_view key) override;
+	void EndDict() override;
+	void StartArray() override;
+	void EndArray() override;
+	void Null() override;
+	void Bool(bool value) override;
+	void Int(int value) override;
+	void Double(double value) override;
+	void String(std::string_view value) override;
+
+	//Справочник из полученных запросов. Имена в запросах ссылаются на хранилище обработчика,
+	//поэтому справочник строится до его уничтожения
+	TransportCatalogue BuildCatalogue();
+
+	//Документ с разделами, кроме base_requests
+	json::ViewDocument BuildSettings();
+
+private:
+	//Глубина вложенности запроса, его словарей расстояний и массивов остановок
+	static const int REQUEST_DEPTH = 3;
+	static const int REQUEST_FIELD_DEPTH = 4;
+
+	enum class RequestKind {
+		UNKNOWN,
+		STOP,
+		BUS
+	};
+
+	void FinishRequest();
+
+	//Имена остановок и автобусов, каждое хранится один раз
+	transport_catalogue::domain::NameArena names_;
+	json::ViewDocumentBuilder settings_;
+	std::vector<AddStopRequest> add_stop_requests_;
+	std::vector<AddBusRequest> add_bus_requests_;
+
+	//Число незавершенных словарей и массивов
+	int depth_ = 0;
+	bool is_base_requests_key_ = false;
+	bool in_base_requests_ = false;
+
+	//Разбираемый запрос: поля обоих видов заполняются до того, как станет известен тип
+	RequestKind kind_ = RequestKind::UNKNOWN;
+	std::string key_;
+	std::string_view distance_to_;
+	AddStopRequest add_stop_request_;
+	AddBusRequest add_bus_request_;
 };
 
 //Возвращает цвет в формате svg::Color
-svg::Color GetColor(const json::Node& color);
+svg::Color GetColor(const json::ViewNode& color);
 
 
 //Обрабатывет stat_request "Stop"
@@ -87,6 +169,30 @@ void ProcessMapRequest(const RequestHandler& req_handler, json::Builder& stats,
 void ProcessRouteRequest(const RequestHandler& req_handler, json::Builder& stats,
 	const detail::StatRequest& stat_request);
 
+//Обрабатывет stat_request "CommonBuses"
+void ProcessCommonBusesRequest(const RequestHandler& req_handler, json::Builder& stats,
+	const detail::StatRequest& stat_request);
+
+//Обрабатывет stat_request "NearestStops"
+void ProcessNearestStopsRequest(const RequestHandler& req_handler, json::Builder& stats,
+	const detail::StatRequest& stat_request);
+
+//Обрабатывет stat_request "StopsInBox"
+void ProcessStopsInBoxRequest(const RequestHandler& req_handler, json::Builder& stats,
+	const detail::StatRequest& stat_request);
+
+//Обрабатывет stat_request "Suggest"
+void ProcessSuggestRequest(const RequestHandler& req_handler, json::Builder& stats,
+	const detail::StatRequest& stat_request);
+
+//Обрабатывет stat_request "AllBuses" и выводит ответ в поток по частям, не строя его целиком
+void ProcessAllBusesRequest(const RequestHandler& req_handler, const detail::StatRequest& stat_request,
+	json::detail::PrintContext context);
+
+//Обрабатывет stat_request "AllStops" и выводит ответ в поток по частям, не строя его целиком
+void ProcessAllStopsRequest(const RequestHandler& req_handler, const detail::StatRequest& stat_request,
+	json::detail::PrintContext context);
+
 }//end namespace detail
 
 } //end namespace json_reader
\ No newline at end of file
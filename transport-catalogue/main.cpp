@@ -2,12 +2,13 @@
 #include "map_renderer.h"
 #include "request_handler.h"
 #include "serialization.h"
+#include "snapshot.h"
 #include "transport_router.h"
 
 using namespace std::literals;
 
 void PrintUsage(std::ostream& stream = std::cerr) {
-	stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+	stream << "Usage: transport_catalogue [make_base|process_requests] [--memory-report]\n"sv;
 }
 
 int main(int argc, char* argv[]) {
@@ -18,29 +19,43 @@ int main(int argc, char* argv[]) {
 	using namespace renderer;
 	using namespace json_reader;
 
-	if (argc != 2) {
+	if (argc != 2 && !(argc == 3 && argv[2] == "--memory-report"sv)) {
 		PrintUsage();
 		return 1;
 	}
 
 	const std::string_view mode(argv[1]);
+	//Отчет о памяти выводится в поток ошибок, чтобы не смешиваться с ответами
+	const bool print_memory_report = argc == 3;
 
 	if (mode == "make_base"sv) {
-		auto doc = ReadFromJSON(std::cin);
-		TransportCatalogue t_catalogue = ProcessBaseRequests(doc);
+		auto [t_catalogue, doc] = ReadBaseInput(std::cin);
 		RenderSettings render_settings = ProcessRenderSettings(doc);
 		RoutingSettings routing_settings = ProcessRoutingSettings(doc);
 		std::filesystem::path path = ProcessPath(doc);
 		Serialize(t_catalogue, render_settings, routing_settings, path);
+		if (print_memory_report) {
+			memory_report::Report report(t_catalogue.GetStopCount());
+			t_catalogue.ReportMemory(report);
+			report.Add("json::ViewDocument", memory_report::OfJson(doc));
+			report.Print(std::cerr);
+		}
 
 	} else if (mode == "process_requests"sv) {
 		auto doc = ReadFromJSON(std::cin);
 		std::filesystem::path path = ProcessPath(doc);
+		//Без файла базы, как и раньше, запросы обрабатываются по пустому справочнику
 		auto [t_catalogue, render_settings, routing_settings] = Deserialize(path);
-		MapRenderer renderer(render_settings);
-		TransportRouter router(t_catalogue, routing_settings);
-		RequestHandler req_handler(t_catalogue, renderer, router);
-		ProcessStatRequests(req_handler, doc, std::cout);
+		const auto snapshot = std::make_shared<transport_snapshot::Snapshot>(
+			std::move(t_catalogue), std::move(render_settings), routing_settings);
+		ProcessStatRequests(snapshot->MakeRequestHandler(), doc, std::cout);
+		if (print_memory_report) {
+			memory_report::Report report(snapshot->GetCatalogue().GetStopCount());
+			snapshot->GetCatalogue().ReportMemory(report);
+			snapshot->GetRouter().ReportMemory(report);
+			report.Add("json::ViewDocument", memory_report::OfJson(doc));
+			report.Print(std::cerr);
+		}
 	} else {
 		PrintUsage();
 		return 1;
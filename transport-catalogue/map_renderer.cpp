@@ -15,36 +15,42 @@ const RenderSettings& MapRenderer::GetSettings() const {
 }
 
 void MapRenderer::RenderMap(svg::Document& map, const std::vector<domain::Bus>& buses,
-	const std::vector<const domain::Stop*>& stops) const {
-	std::vector<geo::Coordinates> geo_coords(stops.size());
+	const std::vector<const domain::Stop*>& stops, const TransportCatalogue& db) const {
+	std::vector<geo::FixedCoordinates> geo_coords(stops.size());
 	std::transform(
 		stops.begin(),
 		stops.end(),
 		geo_coords.begin(),
-		[](const Stop* stop) {return stop->coordinates; }
+		[&db](const Stop* stop) {return db.GetStopCoordinates(stop->id); }
 	);
 	const SphereProjector proj{
 		geo_coords.begin(), geo_coords.end(), render_settings_.width,
 		render_settings_.height, render_settings_.padding
 	};
+	//Каждая остановка проецируется один раз, дальше точки берутся по идентификатору
+	std::vector<svg::Point> stop_points(db.GetStopCount());
+	for (size_t i = 0; i < stops.size(); ++i) {
+		stop_points[stops[i]->id] = proj(geo_coords[i]);
+	}
 
-	RenderBusRouts(map, buses, proj);
-	RenderBusNames(map, buses, proj);
-	RenderStopPoints(map, stops, proj);
-	RenderStopNames(map, stops, proj);
+	RenderBusRouts(map, buses, db, stop_points);
+	RenderBusNames(map, buses, db, stop_points);
+	RenderStopPoints(map, stops, stop_points);
+	RenderStopNames(map, stops, stop_points);
 }
 
-void MapRenderer::RenderBusRouts(svg::Document& map,
-	const std::vector<domain::Bus>& buses, const SphereProjector& proj) const
+void MapRenderer::RenderBusRouts(svg::Document& map, const std::vector<domain::Bus>& buses,
+	const TransportCatalogue& db, const std::vector<svg::Point>& stop_points) const
 {
 	const size_t colors_count = render_settings_.color_palette.size();
 	size_t color_index = 0;
 	for (const auto& bus : buses) {
-		if (bus.stops.empty()) { continue; }
+		const auto stops = db.GetRouteStops(db.GetRoute(bus.route_id));
+		if (stops.empty()) { continue; }
 		const auto& color = render_settings_.color_palette[color_index];
 		svg::Polyline route;
-		for (const auto& stop : bus.stops) {
-			route.AddPoint(proj(stop->coordinates));
+		for (const auto& stop : stops) {
+			route.AddPoint(stop_points[stop]);
 		}
 		route
 			.SetStrokeColor(color)
@@ -58,22 +64,23 @@ void MapRenderer::RenderBusRouts(svg::Document& map,
 	}
 }
 
-void MapRenderer::RenderBusNames(svg::Document& map,
-	const std::vector<domain::Bus>& buses, const SphereProjector& proj) const
+void MapRenderer::RenderBusNames(svg::Document& map, const std::vector<domain::Bus>& buses,
+	const TransportCatalogue& db, const std::vector<svg::Point>& stop_points) const
 {
 	const size_t colors_count = render_settings_.color_palette.size();
 	size_t color_index = 0;
 	for (const auto& bus : buses) {
-		if (bus.stops.empty()) { continue; }
+		const auto stops = db.GetRouteStops(db.GetRoute(bus.route_id));
+		if (stops.empty()) { continue; }
 		const auto& color = render_settings_.color_palette[color_index];
 		svg::Text name;
 		name
 			.SetFillColor(color)
-			.SetData(bus.name)
+			.SetData(std::string{ bus.name })
 			.SetFontSize(render_settings_.bus_label_font_size)
 			.SetFontFamily("Verdana")
 			.SetFontWeight("bold")
-			.SetPosition(proj(bus.stops.front()->coordinates))
+			.SetPosition(stop_points[stops.front()])
 			.SetOffset(render_settings_.bus_label_offset);
 		svg::Text underlayer_name = name;
 		underlayer_name
@@ -84,14 +91,14 @@ void MapRenderer::RenderBusNames(svg::Document& map,
 			.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 		map.Add(underlayer_name);
 		map.Add(name);
-		const auto& last_stop = bus.stops.size() > 2 ?
-			bus.stops[bus.stops.size() / 2] : bus.stops.back();
-		if (!bus.is_roundtrip && bus.stops.front()->name != last_stop->name) {
+		const auto last_stop = stops.size() > 2 ?
+			stops[stops.size() / 2] : stops.back();
+		if (!db.GetRoute(bus.route_id).is_roundtrip && stops.front() != last_stop) {
 			name
-				.SetPosition(proj(last_stop->coordinates))
+				.SetPosition(stop_points[last_stop])
 				.SetOffset(render_settings_.bus_label_offset);
 			underlayer_name
-				.SetPosition(proj(last_stop->coordinates))
+				.SetPosition(stop_points[last_stop])
 				.SetOffset(render_settings_.bus_label_offset);;
 			map.Add(underlayer_name);
 			map.Add(name);
@@ -101,20 +108,20 @@ void MapRenderer::RenderBusNames(svg::Document& map,
 	}
 }
 void MapRenderer::RenderStopPoints(svg::Document& map,
-	const std::vector<const domain::Stop*>& stops, const SphereProjector& proj) const
+	const std::vector<const domain::Stop*>& stops, const std::vector<svg::Point>& stop_points) const
 {
 	svg::Circle stop_point;
 	stop_point
 		.SetFillColor("white")
 		.SetRadius(render_settings_.stop_radius);
 	for (const auto stop : stops) {
-		stop_point.SetCenter(proj(stop->coordinates));
+		stop_point.SetCenter(stop_points[stop->id]);
 		map.Add(stop_point);
 	}
 }
 
 void MapRenderer::RenderStopNames(svg::Document& map,
-	const std::vector<const domain::Stop*>& stops, const SphereProjector& proj) const
+	const std::vector<const domain::Stop*>& stops, const std::vector<svg::Point>& stop_points) const
 {
 	svg::Text stop_name;
 	stop_name
@@ -131,20 +138,21 @@ void MapRenderer::RenderStopNames(svg::Document& map,
 		.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 	for (const auto stop : stops) {
 		stop_name
-			.SetData(stop->name)
-			.SetPosition(proj(stop->coordinates));
+			.SetData(std::string{ stop->name })
+			.SetPosition(stop_points[stop->id]);
 		stop_underlayer_name
-			.SetData(stop->name)
-			.SetPosition(proj(stop->coordinates));
+			.SetData(std::string{ stop->name })
+			.SetPosition(stop_points[stop->id]);
 		map.Add(stop_underlayer_name);
 		map.Add(stop_name);
 	}
 }
 
-svg::Point SphereProjector::operator()(geo::Coordinates coords) const {
+svg::Point SphereProjector::operator()(geo::FixedCoordinates coords) const {
+	//Разность целых координат точна, в градусы переводится только она
 	return {
-		(coords.lng - min_lon_) * zoom_coeff_ + padding_,
-		(max_lat_ - coords.lat) * zoom_coeff_ + padding_
+		(coords.lng - min_lon_) / geo::FIXED_COORDINATES_SCALE * zoom_coeff_ + padding_,
+		(max_lat_ - coords.lat) / geo::FIXED_COORDINATES_SCALE * zoom_coeff_ + padding_
 	};
 }
 
@@ -3,8 +3,10 @@
 #include "svg.h"
 #include "geo.h"
 #include "domain.h"
+#include "transport_catalogue.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <variant>
@@ -16,23 +18,25 @@ namespace renderer {
 using transport_catalogue::domain::Bus;
 using transport_catalogue::domain::Stop;
 using transport_catalogue::geo::Coordinates;
+using transport_catalogue::geo::FixedCoordinates;
 
 static const double EPSILON = 1e-6;
 
 class SphereProjector {
 public:
-	// points_begin и points_end задают начало и конец интервала элементов geo::Coordinates
+	// points_begin и points_end задают начало и конец интервала элементов geo::FixedCoordinates
 	template <typename PointInputIt>
 	SphereProjector(PointInputIt points_begin, PointInputIt points_end,
 		double max_width, double max_height, double padding);
 
 	// Проецирует широту и долготу в координаты внутри SVG-изображения
-	svg::Point operator()(transport_catalogue::geo::Coordinates coords) const;
+	svg::Point operator()(FixedCoordinates coords) const;
 
 private:
 	double padding_;
-	double min_lon_ = 0;
-	double max_lat_ = 0;
+	int32_t min_lon_ = 0;
+	int32_t max_lat_ = 0;
+	//Масштаб в пикселях на градус
 	double zoom_coeff_ = 0;
 
 	static bool IsZero(double value);
@@ -61,27 +65,28 @@ public:
 
 	const RenderSettings& GetSettings() const;
 
+	//db - справочник, из которого берутся остановки путей автобусов
 	void RenderMap(svg::Document& map, const std::vector<Bus>& buses,
-		const std::vector<const Stop*>& stops) const;
+		const std::vector<const Stop*>& stops, const transport_catalogue::TransportCatalogue& db) const;
 
 private:
 	RenderSettings render_settings_;
 
 	//Ломаные линии маршрутов
-	void RenderBusRouts(svg::Document& map,
-		const std::vector<Bus>& buses, const SphereProjector& proj) const;
+	void RenderBusRouts(svg::Document& map, const std::vector<Bus>& buses,
+		const transport_catalogue::TransportCatalogue& db, const std::vector<svg::Point>& stop_points) const;
 
 	//Названия маршрутов
-	void RenderBusNames(svg::Document& map,
-		const std::vector<Bus>& buses, const SphereProjector& proj) const;
+	void RenderBusNames(svg::Document& map, const std::vector<Bus>& buses,
+		const transport_catalogue::TransportCatalogue& db, const std::vector<svg::Point>& stop_points) const;
 
 	//Точки остановок
 	void RenderStopPoints(svg::Document& map,
-		const std::vector<const Stop*>& stops, const SphereProjector& proj) const;
+		const std::vector<const Stop*>& stops, const std::vector<svg::Point>& stop_points) const;
 
 	//Названия остановок
 	void RenderStopNames(svg::Document& map,
-		const std::vector<const Stop*>& stops, const SphereProjector& proj) const;
+		const std::vector<const Stop*>& stops, const std::vector<svg::Point>& stop_points) const;
 };
 
 template <typename PointInputIt>
@@ -95,19 +100,19 @@ SphereProjector::SphereProjector(PointInputIt points_begin, PointInputIt points_
 		points_begin, points_end,
 		[](auto lhs, auto rhs) { return lhs.lng < rhs.lng; });
 	min_lon_ = left_it->lng;
-	const double max_lon = right_it->lng;
+	const double lon_span = (right_it->lng - min_lon_) / transport_catalogue::geo::FIXED_COORDINATES_SCALE;
 	const auto [bottom_it, top_it] = std::minmax_element(
 		points_begin, points_end,
 		[](auto lhs, auto rhs) { return lhs.lat < rhs.lat; });
-	const double min_lat = bottom_it->lat;
 	max_lat_ = top_it->lat;
+	const double lat_span = (max_lat_ - bottom_it->lat) / transport_catalogue::geo::FIXED_COORDINATES_SCALE;
 	std::optional<double> width_zoom;
-	if (!IsZero(max_lon - min_lon_)) {
-		width_zoom = (max_width - 2 * padding) / (max_lon - min_lon_);
+	if (!IsZero(lon_span)) {
+		width_zoom = (max_width - 2 * padding) / lon_span;
 	}
 	std::optional<double> height_zoom;
-	if (!IsZero(max_lat_ - min_lat)) {
-		height_zoom = (max_height - 2 * padding) / (max_lat_ - min_lat);
+	if (!IsZero(lat_span)) {
+		height_zoom = (max_height - 2 * padding) / lat_span;
 	}
 
 	if (width_zoom && height_zoom) {
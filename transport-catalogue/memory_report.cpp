@@ -0,0 +1,86 @@
+#include "memory_report.h"
+
+#include <iomanip>
+#include <utility>
+#include <variant>
+
+namespace memory_report {
+
+namespace {
+
+//Служебные поля узла красно-черного дерева std::map: цвет и три указателя
+const size_t MAP_NODE_HEADER = 4 * sizeof(void*);
+//Строки не длиннее этого хранятся в самом объекте строки
+const size_t SSO_CAPACITY = 15;
+
+size_t OfJsonChildren(const json::ViewNode& node) {
+	if (node.IsArray()) {
+		const auto& array = node.AsArray();
+		size_t bytes = array.capacity() * sizeof(json::ViewNode);
+		for (const auto& item : array) {
+			bytes += OfJsonChildren(item);
+		}
+		return bytes;
+	}
+	if (node.IsMap()) {
+		size_t bytes = 0;
+		for (const auto& [key, value] : node.AsMap()) {
+			bytes += MAP_NODE_HEADER + sizeof(std::pair<const std::string_view, json::ViewNode>)
+				+ OfJsonChildren(value);
+		}
+		return bytes;
+	}
+	return 0;
+}
+
+}//end namespace
+
+size_t OfString(const std::string& value) {
+	return value.capacity() > SSO_CAPACITY ? value.capacity() + 1 : 0;
+}
+
+size_t OfJson(const json::ViewDocument& document) {
+	return document.GetStringsMemoryUsage() + sizeof(json::ViewNode) + OfJsonChildren(document.GetRoot());
+}
+
+Report::Report(size_t stop_count)
+	: stop_count_(stop_count) {}
+
+Report& Report::Add(std::string name, size_t bytes, Growth growth) {
+	entries_.push_back({ std::move(name), bytes, growth });
+	return *this;
+}
+
+size_t Report::GetTotal() const {
+	size_t total = 0;
+	for (const auto& entry : entries_) {
+		total += entry.bytes;
+	}
+	return total;
+}
+
+void Report::Print(std::ostream& output) const {
+	const int name_width = 44;
+	const int bytes_width = 16;
+	output << "Memory report, stops: " << stop_count_ << '\n';
+	size_t linear = 0;
+	size_t quadratic = 0;
+	for (const auto& entry : entries_) {
+		output << "  " << std::left << std::setw(name_width) << entry.name
+			<< std::right << std::setw(bytes_width) << entry.bytes
+			<< (entry.growth == Growth::QUADRATIC ? "  O(stops^2)" : "  O(stops)") << '\n';
+		(entry.growth == Growth::QUADRATIC ? quadratic : linear) += entry.bytes;
+	}
+	output << "  " << std::left << std::setw(name_width) << "total"
+		<< std::right << std::setw(bytes_width) << linear + quadratic << '\n';
+	output << "Extrapolated total by stop count:\n";
+	for (const size_t factor : SCALE_FACTORS) {
+		const double estimate = static_cast<double>(linear) * factor
+			+ static_cast<double>(quadratic) * factor * factor;
+		output << "  " << std::left << std::setw(name_width) << stop_count_ * factor
+			<< std::right << std::setw(bytes_width) << std::fixed << std::setprecision(0) << estimate << '\n';
+	}
+	output.unsetf(std::ios::floatfield);
+}
+
+}//end namespace memory_report
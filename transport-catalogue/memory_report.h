@@ -0,0 +1,65 @@
+#pragma once
+
+#include "json.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace memory_report {
+
+//Оценки памяти, занятой содержимым контейнеров, в байтах без учета самого объекта контейнера.
+//Размеры узлов и блоков соответствуют libstdc++
+
+template <typename T>
+size_t OfVector(const std::vector<T>& values) {
+	return values.capacity() * sizeof(T);
+}
+
+size_t OfString(const std::string& value);
+
+//Хэш-таблицы unordered_*: массив корзин и узлы из указателя на следующий узел,
+//значения и сохраненного хэша
+template <typename HashTable>
+size_t OfHashTable(const HashTable& table) {
+	using Value = typename HashTable::value_type;
+	return table.bucket_count() * sizeof(void*)
+		+ table.size() * (sizeof(void*) + sizeof(Value) + sizeof(size_t));
+}
+
+//Узлы документа JSON, массивы и словари, его текст и раскрытые строки
+size_t OfJson(const json::ViewDocument& document);
+
+//Зависимость объема структуры от числа остановок
+enum class Growth {
+	LINEAR,
+	QUADRATIC
+};
+
+//Отчет об объеме памяти структур с оценкой для большего числа остановок
+class Report {
+public:
+	explicit Report(size_t stop_count);
+
+	Report& Add(std::string name, size_t bytes, Growth growth = Growth::LINEAR);
+
+	size_t GetTotal() const;
+
+	//Объем структур, общий объем и его оценка при росте числа остановок в SCALE_FACTORS раз
+	void Print(std::ostream& output) const;
+
+private:
+	static constexpr size_t SCALE_FACTORS[] = { 2, 10, 100 };
+
+	struct Entry {
+		std::string name;
+		size_t bytes = 0;
+		Growth growth = Growth::LINEAR;
+	};
+
+	size_t stop_count_ = 0;
+	std::vector<Entry> entries_;
+};
+
+}//end namespace memory_report
@@ -0,0 +1,64 @@
+#include "name_arena.h"
+#include "memory_report.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+void NameArena::Reserve(size_t bytes) {
+	if (!blocks_.empty() && blocks_.back().capacity - blocks_.back().size >= bytes) {
+		return;
+	}
+	AddBlock(bytes);
+}
+
+NameArena NameArena::Fork() const {
+	NameArena result;
+	result.blocks_ = blocks_;
+	//Свободное место общих блоков не используется, чтобы хранилища не писали в одну память
+	for (Block& block : result.blocks_) {
+		block.capacity = block.size;
+	}
+	result.names_ = names_;
+	return result;
+}
+
+std::string_view NameArena::Intern(std::string_view name) {
+	const auto existing = names_.find(name);
+	if (existing != names_.end()) {
+		return *existing;
+	}
+	if (blocks_.empty() || blocks_.back().capacity - blocks_.back().size < name.size()) {
+		AddBlock(std::max(MIN_BLOCK_SIZE, name.size()));
+	}
+	Block& block = blocks_.back();
+	char* begin = block.data.get() + block.size;
+	std::memcpy(begin, name.data(), name.size());
+	block.size += name.size();
+	std::string_view result{ begin, name.size() };
+	names_.insert(result);
+	return result;
+}
+
+size_t NameArena::GetCapacity() const {
+	size_t capacity = 0;
+	for (const Block& block : blocks_) {
+		capacity += block.capacity;
+	}
+	return capacity;
+}
+
+size_t NameArena::GetMemoryUsage() const {
+	return GetCapacity() + memory_report::OfVector(blocks_) + memory_report::OfHashTable(names_);
+}
+
+void NameArena::AddBlock(size_t capacity) {
+	blocks_.push_back({ std::shared_ptr<char[]>(new char[capacity]), 0, capacity });
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
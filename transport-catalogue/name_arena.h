@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Хранилище имен остановок и автобусов. Каждое имя хранится один раз
+//в непрерывных блоках памяти, ссылки на имена (string_view) остаются
+//действительными все время жизни хранилища, в том числе после перемещения
+class NameArena {
+public:
+	NameArena() = default;
+	NameArena(NameArena&&) = default;
+	NameArena& operator=(NameArena&&) = default;
+	NameArena(const NameArena&) = delete;
+	NameArena& operator=(const NameArena&) = delete;
+
+	//Резервирует место под имена суммарной длиной bytes одним блоком
+	void Reserve(size_t bytes);
+
+	//Хранилище с теми же именами, разделяющее с этим блоки памяти.
+	//Новые имена каждое из хранилищ пишет в собственные блоки
+	NameArena Fork() const;
+
+	//Возвращает ссылку на копию имени в хранилище, одинаковые имена не дублируются
+	std::string_view Intern(std::string_view name);
+
+	//Суммарный объем выделенных блоков в байтах
+	size_t GetCapacity() const;
+
+	//Память блоков и словаря имен в байтах
+	size_t GetMemoryUsage() const;
+
+private:
+	static constexpr size_t MIN_BLOCK_SIZE = 4096;
+
+	struct Block {
+		std::shared_ptr<char[]> data;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+
+	void AddBlock(size_t capacity);
+
+	std::vector<Block> blocks_;
+	std::unordered_set<std::string_view> names_;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "ranges.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Вектор из страниц по PAGE_SIZE элементов. Копия разделяет страницы с оригиналом,
+//страница копируется при первом изменении (copy-on-write): копирование вектора стоит
+//O(size / PAGE_SIZE), а изменение - не больше одной страницы на измененный элемент
+template <typename T, size_t PAGE_SIZE = 1024>
+class PagedVector {
+	using Page = std::vector<T>;
+
+public:
+	class ConstIterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		ConstIterator() = default;
+
+		ConstIterator(const PagedVector* vector, size_t index)
+			: vector_(vector), index_(index) {}
+
+		const T& operator*() const { return (*vector_)[index_]; }
+		const T* operator->() const { return &(*vector_)[index_]; }
+		const T& operator[](difference_type n) const { return (*vector_)[index_ + n]; }
+		ConstIterator& operator++() { ++index_; return *this; }
+		ConstIterator operator++(int) { ConstIterator result = *this; ++index_; return result; }
+		ConstIterator& operator--() { --index_; return *this; }
+		ConstIterator operator--(int) { ConstIterator result = *this; --index_; return result; }
+		ConstIterator& operator+=(difference_type n) { index_ += n; return *this; }
+		ConstIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+		ConstIterator operator+(difference_type n) const { return { vector_, index_ + n }; }
+		ConstIterator operator-(difference_type n) const { return { vector_, index_ - n }; }
+		difference_type operator-(const ConstIterator& other) const {
+			return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+		}
+		bool operator==(const ConstIterator& other) const { return index_ == other.index_; }
+		bool operator!=(const ConstIterator& other) const { return index_ != other.index_; }
+		bool operator<(const ConstIterator& other) const { return index_ < other.index_; }
+		bool operator>(const ConstIterator& other) const { return index_ > other.index_; }
+		bool operator<=(const ConstIterator& other) const { return index_ <= other.index_; }
+		bool operator>=(const ConstIterator& other) const { return index_ >= other.index_; }
+
+	private:
+		const PagedVector* vector_ = nullptr;
+		size_t index_ = 0;
+	};
+
+	PagedVector() = default;
+
+	const T& operator[](size_t index) const {
+		return (*pages_[index / PAGE_SIZE])[index % PAGE_SIZE];
+	}
+
+	const T& back() const {
+		return (*this)[size_ - 1];
+	}
+
+	ConstIterator begin() const {
+		return { this, 0 };
+	}
+
+	ConstIterator end() const {
+		return { this, size_ };
+	}
+
+	//Элемент для изменения. Ссылка действительна до следующего изменения вектора
+	T& GetMutable(size_t index) {
+		return GetMutablePage(index / PAGE_SIZE)[index % PAGE_SIZE];
+	}
+
+	void assign(size_t size, const T& value) {
+		pages_.clear();
+		size_ = 0;
+		resize(size, value);
+	}
+
+	void resize(size_t size, const T& value = T{}) {
+		const size_t page_count = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+		if (size < size_) {
+			pages_.resize(page_count);
+			size_ = size;
+			return;
+		}
+		//Хвост последней страницы за пределами размера заполняется заново
+		if (size_ % PAGE_SIZE != 0) {
+			Page& page = GetMutablePage(size_ / PAGE_SIZE);
+			std::fill(page.begin() + size_ % PAGE_SIZE, page.end(), value);
+		}
+		pages_.reserve(page_count);
+		while (pages_.size() < page_count) {
+			pages_.push_back(std::make_shared<Page>(PAGE_SIZE, value));
+		}
+		size_ = size;
+	}
+
+	void push_back(T value) {
+		if (size_ == pages_.size() * PAGE_SIZE) {
+			pages_.push_back(std::make_shared<Page>(PAGE_SIZE));
+		}
+		GetMutable(size_) = std::move(value);
+		++size_;
+	}
+
+	void reserve(size_t size) {
+		pages_.reserve((size + PAGE_SIZE - 1) / PAGE_SIZE);
+	}
+
+	void clear() {
+		pages_.clear();
+		size_ = 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	//Число страниц, которые вектор разделяет с копиями
+	size_t GetSharedPageCount() const {
+		return static_cast<size_t>(std::count_if(pages_.begin(), pages_.end(),
+			[](const auto& page) { return page.use_count() > 1; }));
+	}
+
+	size_t GetPageCount() const {
+		return pages_.size();
+	}
+
+	//Память страниц и указателей на них в байтах, включая страницы, общие с копиями.
+	//Блок make_shared содержит указатель на таблицу виртуальных функций и два счетчика
+	size_t GetMemoryUsage() const {
+		return pages_.capacity() * sizeof(std::shared_ptr<Page>)
+			+ pages_.size() * (sizeof(void*) + 2 * sizeof(int) + sizeof(Page) + PAGE_SIZE * sizeof(T));
+	}
+
+private:
+	Page& GetMutablePage(size_t page_index) {
+		auto& page = pages_[page_index];
+		if (page.use_count() > 1) {
+			page = std::make_shared<Page>(*page);
+		} else {
+			//Копия, освободившая страницу в другом потоке, закончила работу с ней
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *page;
+	}
+
+	std::vector<std::shared_ptr<Page>> pages_;
+	size_t size_ = 0;
+};
+
+//Последовательности элементов, каждая из которых хранится подряд в одной странице.
+//Копия разделяет страницы с оригиналом: добавление копирует только последнюю страницу,
+//замена - страницу, где остается последовательность. Место замененных последовательностей
+//освобождается, когда его становится больше, чем занято действующими
+template <typename T, size_t PAGE_SIZE = 4096>
+class PagedSequences {
+	using Page = std::vector<T>;
+
+public:
+	PagedSequences() = default;
+
+	//Добавляет последовательность в конец, возвращает ее номер
+	size_t Add(const T* data, size_t count) {
+		locations_.push_back(Allocate(data, count));
+		used_ += count;
+		return locations_.size() - 1;
+	}
+
+	//Заменяет последовательность с номером index. Не длиннее прежней - записывается на ее место
+	void Set(size_t index, const T* data, size_t count) {
+		Location& location = locations_.GetMutable(index);
+		used_ = used_ - location.count + count;
+		if (count <= location.count) {
+			std::copy(data, data + count, GetMutablePage(location.page).begin() + location.offset);
+			unused_ += location.count - count;
+			location.count = static_cast<uint32_t>(count);
+		} else {
+			unused_ += location.count;
+			location = Allocate(data, count);
+		}
+		if (unused_ > used_ && unused_ > PAGE_SIZE) {
+			Compact();
+		}
+	}
+
+	//Элементы последовательности действительны до следующего изменения
+	ranges::Range<const T*> operator[](size_t index) const {
+		const Location& location = locations_[index];
+		const T* begin = pages_[location.page]->data() + location.offset;
+		return { begin, begin + location.count };
+	}
+
+	size_t size() const {
+		return locations_.size();
+	}
+
+	//Память страниц и размещения последовательностей в байтах, включая страницы, общие с копиями
+	size_t GetMemoryUsage() const {
+		size_t bytes = locations_.GetMemoryUsage() + pages_.capacity() * sizeof(std::shared_ptr<Page>);
+		for (const auto& page : pages_) {
+			bytes += sizeof(void*) + 2 * sizeof(int) + sizeof(Page) + page->capacity() * sizeof(T);
+		}
+		return bytes;
+	}
+
+private:
+	struct Location {
+		uint32_t page = 0;
+		uint32_t offset = 0;
+		uint32_t count = 0;
+	};
+
+	//Дописывает элементы в последнюю страницу, если они в ней помещаются, иначе в новую
+	Location Allocate(const T* data, size_t count) {
+		if (pages_.empty() || pages_.back()->size() + count > std::max(PAGE_SIZE, pages_.back()->capacity())) {
+			pages_.push_back(std::make_shared<Page>());
+			pages_.back()->reserve(std::max(PAGE_SIZE, count));
+		}
+		Page& page = GetMutablePage(pages_.size() - 1);
+		const Location location{ static_cast<uint32_t>(pages_.size() - 1), static_cast<uint32_t>(page.size()),
+			static_cast<uint32_t>(count) };
+		page.insert(page.end(), data, data + count);
+		return location;
+	}
+
+	//Переписывает действующие последовательности в новые страницы подряд
+	void Compact() {
+		PagedSequences compacted;
+		for (size_t index = 0; index < locations_.size(); ++index) {
+			const auto sequence = (*this)[index];
+			compacted.Add(sequence.begin(), static_cast<size_t>(sequence.end() - sequence.begin()));
+		}
+		*this = std::move(compacted);
+	}
+
+	Page& GetMutablePage(size_t page_index) {
+		auto& page = pages_[page_index];
+		if (page.use_count() > 1) {
+			//Копия сохраняет запас места, чтобы дописывание не перемещало страницу
+			auto copy = std::make_shared<Page>();
+			copy->reserve(page->capacity());
+			copy->assign(page->begin(), page->end());
+			page = std::move(copy);
+		} else {
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *page;
+	}
+
+	PagedVector<Location> locations_;
+	std::vector<std::shared_ptr<Page>> pages_;
+	//Элементы действующих и замененных последовательностей
+	size_t used_ = 0;
+	size_t unused_ = 0;
+};
+
+//Значение, общее для копий до первого изменения (copy-on-write).
+//Подходит для индексов, которые строятся целиком и затем только читаются
+template <typename T>
+class CopyOnWrite {
+public:
+	CopyOnWrite()
+		: value_(std::make_shared<T>()) {}
+
+	CopyOnWrite(T value)
+		: value_(std::make_shared<T>(std::move(value))) {}
+
+	const T& operator*() const {
+		return *value_;
+	}
+
+	const T* operator->() const {
+		return value_.get();
+	}
+
+	//Значение для изменения. Значение, общее с копиями, копируется
+	T& GetMutable() {
+		if (value_.use_count() > 1) {
+			value_ = std::make_shared<T>(*value_);
+		} else {
+			//Копия, освободившая значение в другом потоке, закончила работу с ним
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *value_;
+	}
+
+private:
+	std::shared_ptr<T> value_;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace detail {
+
+//Вызывает fn(i) для всех i из [0, count), распределяя индексы по потокам с шагом,
+//не меньше min_per_thread индексов на поток
+template <typename Fn>
+void ParallelFor(size_t count, size_t min_per_thread, Fn fn) {
+	const size_t thread_count = std::min<size_t>(
+		std::max(1u, std::thread::hardware_concurrency()),
+		(count + min_per_thread - 1) / min_per_thread);
+	auto run = [&fn, count, thread_count](size_t thread_index) {
+		for (size_t i = thread_index; i < count; i += thread_count) {
+			fn(i);
+		}
+	};
+	std::vector<std::thread> threads;
+	for (size_t thread_index = 1; thread_index < thread_count; ++thread_index) {
+		threads.emplace_back(run, thread_index);
+	}
+	if (thread_count > 0) {
+		run(0);
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+}//end namespace detail
+
+}//end namespace transport_catalogue
@@ -0,0 +1,142 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <unordered_map>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+namespace {
+
+//Финализатор splitmix64
+uint64_t Mix(uint64_t value) {
+	value ^= value >> 30;
+	value *= 0xBF58476D1CE4E5B9ull;
+	value ^= value >> 27;
+	value *= 0x94D049BB133111EBull;
+	value ^= value >> 31;
+	return value;
+}
+
+}//end namespace
+
+PerfectHash::PerfectHash(std::vector<uint32_t> seeds, std::vector<uint32_t> slot_values)
+	: seeds_(std::move(seeds))
+	, slot_values_(std::move(slot_values)) {
+	assert(seeds_.empty() == slot_values_.empty());
+}
+
+std::optional<PerfectHash> PerfectHash::Build(const std::vector<std::string_view>& keys) {
+	PerfectHash result;
+	if (keys.empty()) {
+		return result;
+	}
+	result.seeds_.assign(std::max<size_t>(1, keys.size() / KEYS_PER_BUCKET), 0);
+	result.slot_values_.assign(keys.size(), 0);
+
+	//Равные ключи не разделить никакой затравкой, размещается только последний из них.
+	//Ячейки остальных остаются свободными
+	std::unordered_map<std::string_view, uint32_t> last_key;
+	last_key.reserve(keys.size());
+	for (uint32_t key = 0; key < keys.size(); ++key) {
+		last_key[keys[key]] = key;
+	}
+	std::vector<uint64_t> hashes(keys.size());
+	std::vector<std::vector<uint32_t>> buckets(result.seeds_.size());
+	for (uint32_t key = 0; key < keys.size(); ++key) {
+		if (last_key.at(keys[key]) != key) {
+			continue;
+		}
+		hashes[key] = Hash(keys[key]);
+		buckets[result.GetBucket(hashes[key])].push_back(key);
+	}
+	//Последней корзине с одним ключом достаточно в среднем keys.size() попыток,
+	//за max_seed попыток ключ не размещается с вероятностью порядка e^-64
+	const uint64_t max_seed = std::min<uint64_t>(UINT32_MAX, 64 * static_cast<uint64_t>(keys.size()) + 1024);
+	//Большие корзины размещаются первыми, пока свободных ячеек много
+	std::vector<uint32_t> bucket_order(buckets.size());
+	std::iota(bucket_order.begin(), bucket_order.end(), 0u);
+	std::stable_sort(bucket_order.begin(), bucket_order.end(), [&buckets](uint32_t lhs, uint32_t rhs) {
+		return buckets[lhs].size() > buckets[rhs].size();
+	});
+
+	std::vector<bool> is_taken(keys.size(), false);
+	std::vector<size_t> slots;
+	for (const uint32_t bucket : bucket_order) {
+		const auto& bucket_keys = buckets[bucket];
+		if (bucket_keys.empty()) {
+			break;
+		}
+		for (uint32_t seed = 0; ; ++seed) {
+			//Разные ключи с одинаковым хэшем не разделить никакой затравкой
+			if (seed == max_seed) {
+				return std::nullopt;
+			}
+			slots.clear();
+			bool is_placed = true;
+			for (const uint32_t key : bucket_keys) {
+				const size_t slot = result.GetSlot(hashes[key], seed);
+				if (is_taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+					is_placed = false;
+					break;
+				}
+				slots.push_back(slot);
+			}
+			if (!is_placed) {
+				continue;
+			}
+			result.seeds_[bucket] = seed;
+			for (size_t i = 0; i < slots.size(); ++i) {
+				is_taken[slots[i]] = true;
+				result.slot_values_[slots[i]] = bucket_keys[i];
+			}
+			break;
+		}
+	}
+	return result;
+}
+
+std::optional<uint32_t> PerfectHash::Find(std::string_view key) const {
+	if (slot_values_.empty()) {
+		return std::nullopt;
+	}
+	const uint64_t hash = Hash(key);
+	return slot_values_[GetSlot(hash, seeds_[GetBucket(hash)])];
+}
+
+size_t PerfectHash::size() const {
+	return slot_values_.size();
+}
+
+const std::vector<uint32_t>& PerfectHash::GetSeeds() const {
+	return seeds_;
+}
+
+const std::vector<uint32_t>& PerfectHash::GetSlotValues() const {
+	return slot_values_;
+}
+
+//FNV-1a, 64 бита
+uint64_t PerfectHash::Hash(std::string_view key) {
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (const char c : key) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001B3ull;
+	}
+	return Mix(hash);
+}
+
+size_t PerfectHash::GetBucket(uint64_t hash) const {
+	return static_cast<size_t>((hash >> 32) % seeds_.size());
+}
+
+size_t PerfectHash::GetSlot(uint64_t hash, uint32_t seed) const {
+	return static_cast<size_t>(Mix(hash ^ (seed * 0x9E3779B97F4A7C15ull)) % slot_values_.size());
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Минимальная совершенная хэш-функция над фиксированным набором имен (hash and displace).
+//Ключи распределяются по корзинам, для каждой корзины подбирается затравка, при которой
+//ее ключи попадают в свободные ячейки. Хэш не зависит от платформы, поэтому функцию
+//можно сохранить в базе и использовать без перестроения
+class PerfectHash {
+public:
+	PerfectHash() = default;
+
+	//Функция по готовым данным, например, из сериализованной базы
+	PerfectHash(std::vector<uint32_t> seeds, std::vector<uint32_t> slot_values);
+
+	//Строит функцию по ключам: ключ keys[i] получает значение i, из равных ключей -
+	//значение последнего. Функция покрывает значения [0, keys.size()).
+	//Возвращает nullopt, если ключи не удалось разместить (совпали 64-битные хэши)
+	static std::optional<PerfectHash> Build(const std::vector<std::string_view>& keys);
+
+	//Возвращает значение, которое получил бы key, если он входит в набор ключей.
+	//Принадлежность набору вызывающий проверяет сравнением имени по этому значению
+	std::optional<uint32_t> Find(std::string_view key) const;
+
+	size_t size() const;
+
+	const std::vector<uint32_t>& GetSeeds() const;
+	const std::vector<uint32_t>& GetSlotValues() const;
+
+private:
+	//Среднее число ключей в корзине
+	static constexpr size_t KEYS_PER_BUCKET = 4;
+
+	static uint64_t Hash(std::string_view key);
+	size_t GetBucket(uint64_t hash) const;
+	size_t GetSlot(uint64_t hash, uint32_t seed) const;
+
+	std::vector<uint32_t> seeds_;
+	//Значение ключа по номеру ячейки
+	std::vector<uint32_t> slot_values_;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
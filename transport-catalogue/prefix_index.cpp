@@ -0,0 +1,148 @@
+#include "prefix_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+namespace {
+
+void WriteVarint(std::string& data, size_t value) {
+	while (value >= 0x80) {
+		data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back(static_cast<char>(value));
+}
+
+size_t ReadVarint(const std::string& data, size_t& pos) {
+	size_t value = 0;
+	for (int shift = 0; ; shift += 7) {
+		const auto byte = static_cast<unsigned char>(data[pos++]);
+		value |= static_cast<size_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+}
+
+bool StartsWith(std::string_view name, std::string_view prefix) {
+	return name.substr(0, prefix.size()) == prefix;
+}
+
+}//end namespace
+
+PrefixIndex::PrefixIndex(std::string data, std::vector<uint32_t> bucket_offsets, std::vector<uint32_t> refs)
+	: data_(std::move(data))
+	, bucket_offsets_(std::move(bucket_offsets))
+	, refs_(std::move(refs)) {
+	assert(bucket_offsets_.size() == (refs_.size() + BUCKET_SIZE - 1) / BUCKET_SIZE);
+}
+
+PrefixIndex PrefixIndex::Build(std::vector<std::pair<std::string_view, Entry>> names) {
+	std::sort(names.begin(), names.end(), [](const auto& lhs, const auto& rhs) {
+		return std::tie(lhs.first, lhs.second.kind, lhs.second.id)
+			< std::tie(rhs.first, rhs.second.kind, rhs.second.id);
+	});
+	PrefixIndex index;
+	index.refs_.reserve(names.size());
+	index.bucket_offsets_.reserve((names.size() + BUCKET_SIZE - 1) / BUCKET_SIZE);
+	std::string_view previous;
+	for (size_t i = 0; i < names.size(); ++i) {
+		const auto& [name, entry] = names[i];
+		size_t shared = 0;
+		if (i % BUCKET_SIZE == 0) {
+			index.bucket_offsets_.push_back(static_cast<uint32_t>(index.data_.size()));
+		} else {
+			const size_t max_shared = std::min(previous.size(), name.size());
+			while (shared < max_shared && previous[shared] == name[shared]) {
+				++shared;
+			}
+		}
+		WriteVarint(index.data_, shared);
+		WriteVarint(index.data_, name.size() - shared);
+		index.data_.append(name.substr(shared));
+		index.refs_.push_back(entry.id * 2 + static_cast<uint32_t>(entry.kind));
+		previous = name;
+	}
+	index.data_.shrink_to_fit();
+	return index;
+}
+
+std::vector<PrefixIndex::Entry> PrefixIndex::FindByPrefix(std::string_view prefix, size_t limit) const {
+	std::vector<Entry> result;
+	if (refs_.empty() || limit == 0) {
+		return result;
+	}
+	//Первый блок, начальное имя которого не меньше префикса. Подходящие имена
+	//могут начинаться и в конце предыдущего блока
+	std::string name;
+	const auto bucket_it = std::partition_point(bucket_offsets_.begin(), bucket_offsets_.end(),
+		[this, prefix, &name](uint32_t offset) {
+			DecodeName(offset, name);
+			return std::string_view{ name } < prefix;
+		});
+	size_t bucket = static_cast<size_t>(bucket_it - bucket_offsets_.begin());
+	if (bucket > 0) {
+		--bucket;
+	}
+	size_t pos = bucket_offsets_[bucket];
+	for (size_t i = bucket * BUCKET_SIZE; i < refs_.size(); ++i) {
+		pos = DecodeName(pos, name);
+		if (StartsWith(name, prefix)) {
+			result.push_back(UnpackRef(refs_[i]));
+			if (result.size() == limit) {
+				break;
+			}
+		} else if (std::string_view{ name } > prefix) {
+			break;
+		}
+	}
+	return result;
+}
+
+std::vector<uint32_t> PrefixIndex::GetIdsByName(Kind kind) const {
+	std::vector<uint32_t> ids;
+	for (const uint32_t ref : refs_) {
+		const Entry entry = UnpackRef(ref);
+		if (entry.kind == kind) {
+			ids.push_back(entry.id);
+		}
+	}
+	return ids;
+}
+
+size_t PrefixIndex::size() const {
+	return refs_.size();
+}
+
+const std::string& PrefixIndex::GetData() const {
+	return data_;
+}
+
+const std::vector<uint32_t>& PrefixIndex::GetBucketOffsets() const {
+	return bucket_offsets_;
+}
+
+const std::vector<uint32_t>& PrefixIndex::GetRefs() const {
+	return refs_;
+}
+
+size_t PrefixIndex::DecodeName(size_t pos, std::string& name) const {
+	const size_t shared = ReadVarint(data_, pos);
+	const size_t suffix_size = ReadVarint(data_, pos);
+	name.resize(shared);
+	name.append(data_, pos, suffix_size);
+	return pos + suffix_size;
+}
+
+PrefixIndex::Entry PrefixIndex::UnpackRef(uint32_t ref) {
+	return { static_cast<Kind>(ref % 2), ref / 2 };
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
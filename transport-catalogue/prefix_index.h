@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Индекс имен остановок и автобусов для поиска по префиксу.
+//Имена упорядочены и сжаты фронтальным кодированием: в каждом блоке из BUCKET_SIZE имен
+//первое хранится полностью, остальные - длиной общего с предыдущим префикса и суффиксом.
+//Длины записываются в формате varint
+class PrefixIndex {
+public:
+	enum class Kind : uint8_t {
+		STOP,
+		BUS
+	};
+
+	struct Entry {
+		Kind kind = Kind::STOP;
+		uint32_t id = 0;
+	};
+
+	PrefixIndex() = default;
+
+	//Индекс по готовым данным, например, из сериализованной базы
+	PrefixIndex(std::string data, std::vector<uint32_t> bucket_offsets, std::vector<uint32_t> refs);
+
+	//Строит индекс по именам, порядок имен не важен
+	static PrefixIndex Build(std::vector<std::pair<std::string_view, Entry>> names);
+
+	//Не более limit записей с именами, начинающимися с prefix, в порядке имен
+	std::vector<Entry> FindByPrefix(std::string_view prefix, size_t limit) const;
+
+	//Идентификаторы всех записей вида kind в порядке имен
+	std::vector<uint32_t> GetIdsByName(Kind kind) const;
+
+	size_t size() const;
+
+	const std::string& GetData() const;
+	const std::vector<uint32_t>& GetBucketOffsets() const;
+	//Записи в порядке имен, закодированные как id * 2 + kind
+	const std::vector<uint32_t>& GetRefs() const;
+
+private:
+	static constexpr size_t BUCKET_SIZE = 16;
+
+	//Декодирует имя, начинающееся с позиции pos, поверх предыдущего имени name.
+	//Возвращает позицию следующего имени
+	size_t DecodeName(size_t pos, std::string& name) const;
+
+	static Entry UnpackRef(uint32_t ref);
+
+	std::string data_;
+	std::vector<uint32_t> bucket_offsets_;
+	std::vector<uint32_t> refs_;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
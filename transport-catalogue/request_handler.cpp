@@ -18,6 +18,72 @@ std::optional<StopStat> RequestHandler::GetStopStat(const std::string_view& stop
 	return db_.GetStopStat(stop_name);
 }
 
+// Возвращают информацию о маршруте и остановке по идентификатору (запросы AllBuses, AllStops)
+BusStat RequestHandler::GetBusStat(domain::BusId bus) const {
+	return db_.GetBusStat(bus);
+}
+
+StopStat RequestHandler::GetStopStat(domain::StopId stop) const {
+	return db_.GetStopStat(stop);
+}
+
+// Возвращают идентификаторы всех автобусов и остановок, упорядоченные по имени
+const std::vector<domain::BusId>& RequestHandler::GetBusesByName() const {
+	return db_.GetStopBusIndex().GetBusesByName();
+}
+
+std::vector<domain::StopId> RequestHandler::GetStopsByName() const {
+	//Индекс имен уже упорядочен, его записи остановок и есть ответ
+	return db_.GetPrefixIndex().GetIdsByName(domain::PrefixIndex::Kind::STOP);
+}
+
+// Возвращает маршруты, проходящие через обе остановки (запрос CommonBuses)
+std::optional<std::vector<domain::BusId>> RequestHandler::GetCommonBuses(
+	const std::string_view& lhs_stop_name, const std::string_view& rhs_stop_name) const {
+	return db_.GetCommonBuses(lhs_stop_name, rhs_stop_name);
+}
+
+// Возвращает не более count ближайших к точке остановок в радиусе max_distance (запрос NearestStops)
+std::vector<std::pair<const domain::Stop*, double>> RequestHandler::GetNearestStops(
+	geo::Coordinates point, size_t count, double max_distance) const {
+	std::vector<std::pair<const domain::Stop*, double>> result;
+	for (const auto& [stop, distance] : db_.FindNearestStops(point, count, max_distance)) {
+		result.emplace_back(&db_.GetStop(stop), distance);
+	}
+	return result;
+}
+
+// Возвращает остановки в прямоугольнике, упорядоченные по имени (запрос StopsInBox)
+std::vector<const domain::Stop*> RequestHandler::GetStopsInBox(
+	geo::Coordinates min, geo::Coordinates max) const {
+	std::vector<const domain::Stop*> stops;
+	for (const auto stop : db_.FindStopsInBox(min, max)) {
+		stops.push_back(&db_.GetStop(stop));
+	}
+	std::sort(stops.begin(),
+		stops.end(),
+		[](const auto& lhs, const auto& rhs) {return lhs->name < rhs->name; }
+	);
+	return stops;
+}
+
+// Возвращает не более limit имен остановок и автобусов, начинающихся с prefix (запрос Suggest)
+std::vector<std::pair<std::string_view, domain::PrefixIndex::Kind>> RequestHandler::Suggest(
+	std::string_view prefix, size_t limit) const {
+	std::vector<std::pair<std::string_view, domain::PrefixIndex::Kind>> result;
+	for (const auto& entry : db_.FindByPrefix(prefix, limit)) {
+		const auto name = entry.kind == domain::PrefixIndex::Kind::STOP
+			? db_.GetStop(entry.id).name : db_.GetBus(entry.id).name;
+		result.emplace_back(name, entry.kind);
+	}
+	return result;
+}
+
+// Возвращает имя автобуса по идентификатору
+std::string_view RequestHandler::GetBusName(domain::BusId bus) const {
+	return db_.GetBus(bus).name;
+}
+
 //Рисует карту (запрос Map)
 void RequestHandler::RenderMap(svg::Document& map) const {
 	std::vector<domain::Bus> buses{ db_.GetBuses().begin(), db_.GetBuses().end() };
@@ -30,7 +96,7 @@ void RequestHandler::RenderMap(svg::Document& map) const {
 		stops.end(),
 		[](const auto& lhs, const auto& rhs) {return lhs->name < rhs->name; }
 	);
-	renderer_.RenderMap(map, buses, stops);
+	renderer_.RenderMap(map, buses, stops, db_);
 }
 
 //Строит мршрут (запрос Route)
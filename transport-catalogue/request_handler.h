@@ -27,6 +27,33 @@ public:
 	// Возвращает маршруты, проходящие через остановку (запрос Stop)
 	std::optional<StopStat> GetStopStat(const std::string_view& stop_name) const;
 
+	// Возвращают информацию о маршруте и остановке по идентификатору (запросы AllBuses, AllStops)
+	BusStat GetBusStat(transport_catalogue::domain::BusId bus) const;
+	StopStat GetStopStat(transport_catalogue::domain::StopId stop) const;
+
+	// Возвращают идентификаторы всех автобусов и остановок, упорядоченные по имени
+	const std::vector<transport_catalogue::domain::BusId>& GetBusesByName() const;
+	std::vector<transport_catalogue::domain::StopId> GetStopsByName() const;
+
+	// Возвращает маршруты, проходящие через обе остановки (запрос CommonBuses)
+	std::optional<std::vector<transport_catalogue::domain::BusId>> GetCommonBuses(
+		const std::string_view& lhs_stop_name, const std::string_view& rhs_stop_name) const;
+
+	// Возвращает не более count ближайших к точке остановок в радиусе max_distance (запрос NearestStops)
+	std::vector<std::pair<const transport_catalogue::domain::Stop*, double>> GetNearestStops(
+		transport_catalogue::geo::Coordinates point, size_t count, double max_distance) const;
+
+	// Возвращает остановки в прямоугольнике, упорядоченные по имени (запрос StopsInBox)
+	std::vector<const transport_catalogue::domain::Stop*> GetStopsInBox(
+		transport_catalogue::geo::Coordinates min, transport_catalogue::geo::Coordinates max) const;
+
+	// Возвращает не более limit имен остановок и автобусов, начинающихся с prefix (запрос Suggest)
+	std::vector<std::pair<std::string_view, transport_catalogue::domain::PrefixIndex::Kind>> Suggest(
+		std::string_view prefix, size_t limit) const;
+
+	// Возвращает имя автобуса по идентификатору
+	std::string_view GetBusName(transport_catalogue::domain::BusId bus) const;
+
 	//Рисует карту (запрос Map)
 	void RenderMap(svg::Document& map) const;
 
@@ -0,0 +1,130 @@
+#include "road_distances.h"
+
+#include <algorithm>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+// ---------- RoadDistances::ConstIterator ------------------
+RoadDistances::ConstIterator::ConstIterator(const Slots& slots, size_t index)
+	: slots_(&slots)
+	, index_(index) {
+	SkipEmpty();
+}
+
+RoadDistances::ConstIterator::value_type RoadDistances::ConstIterator::operator*() const {
+	const Slot& slot = (*slots_)[index_];
+	return { StopPair{ static_cast<StopId>(slot.key >> 32), static_cast<StopId>(slot.key) },
+		slot.distance };
+}
+
+RoadDistances::ConstIterator& RoadDistances::ConstIterator::operator++() {
+	++index_;
+	SkipEmpty();
+	return *this;
+}
+
+bool RoadDistances::ConstIterator::operator==(const ConstIterator& other) const {
+	return index_ == other.index_;
+}
+
+bool RoadDistances::ConstIterator::operator!=(const ConstIterator& other) const {
+	return index_ != other.index_;
+}
+
+void RoadDistances::ConstIterator::SkipEmpty() {
+	while (index_ != slots_->size() && (*slots_)[index_].key == EMPTY_KEY) {
+		++index_;
+	}
+}
+
+// ---------- RoadDistances ------------------
+void RoadDistances::Reserve(size_t count) {
+	size_t capacity = std::max(MIN_CAPACITY, slots_.size());
+	while (capacity < count * 2) {
+		capacity *= 2;
+	}
+	if (capacity > slots_.size()) {
+		Rehash(capacity);
+	}
+}
+
+void RoadDistances::Set(StopId from, StopId to, int distance) {
+	if ((size_ + 1) * 2 > slots_.size()) {
+		Rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+	}
+	const uint64_t key = PackKey(from, to);
+	Slot& slot = slots_.GetMutable(FindSlot(key));
+	if (slot.key == EMPTY_KEY) {
+		slot.key = key;
+		++size_;
+	}
+	slot.distance = distance;
+}
+
+std::optional<int> RoadDistances::Find(StopId from, StopId to) const {
+	if (slots_.empty()) {
+		return std::nullopt;
+	}
+	const Slot& slot = slots_[FindSlot(PackKey(from, to))];
+	if (slot.key == EMPTY_KEY) {
+		return std::nullopt;
+	}
+	return slot.distance;
+}
+
+std::optional<int> RoadDistances::Get(StopId from, StopId to) const {
+	if (const auto distance = Find(from, to)) {
+		return distance;
+	}
+	return Find(to, from);
+}
+
+size_t RoadDistances::size() const {
+	return size_;
+}
+
+size_t RoadDistances::GetMemoryUsage() const {
+	return slots_.GetMemoryUsage();
+}
+
+RoadDistances::ConstIterator RoadDistances::begin() const {
+	return { slots_, 0 };
+}
+
+RoadDistances::ConstIterator RoadDistances::end() const {
+	return { slots_, slots_.size() };
+}
+
+uint64_t RoadDistances::PackKey(StopId from, StopId to) {
+	return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+size_t RoadDistances::FindSlot(uint64_t key) const {
+	const size_t mask = slots_.size() - 1;
+	size_t index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+	while (slots_[index].key != EMPTY_KEY && slots_[index].key != key) {
+		index = (index + 1) & mask;
+	}
+	return index;
+}
+
+void RoadDistances::Rehash(size_t capacity) {
+	Slots old_slots = std::move(slots_);
+	slots_.assign(capacity, Slot{});
+	shift_ = 64;
+	for (size_t i = capacity; i > 1; i >>= 1) {
+		--shift_;
+	}
+	for (size_t i = 0; i < old_slots.size(); ++i) {
+		const Slot& slot = old_slots[i];
+		if (slot.key != EMPTY_KEY) {
+			slots_.GetMutable(FindSlot(slot.key)) = slot;
+		}
+	}
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
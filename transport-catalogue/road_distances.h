@@ -0,0 +1,91 @@
+#pragma once
+
+#include "domain.h"
+#include "paged_vector.h"
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Хранилище расстояний по дорогам между остановками.
+//Хэш-таблица с открытой адресацией и линейным пробированием,
+//ключ - пара идентификаторов остановок, упакованная в 64 бита.
+//Таблица хранится страницами: копия разделяет их с оригиналом до первого изменения
+class RoadDistances {
+	struct Slot {
+		uint64_t key = EMPTY_KEY;
+		int distance = 0;
+	};
+	using Slots = PagedVector<Slot>;
+
+public:
+	class ConstIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<StopPair, int>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = value_type;
+
+		ConstIterator(const Slots& slots, size_t index);
+
+		value_type operator*() const;
+		ConstIterator& operator++();
+		bool operator==(const ConstIterator& other) const;
+		bool operator!=(const ConstIterator& other) const;
+
+	private:
+		void SkipEmpty();
+
+		const Slots* slots_;
+		size_t index_;
+	};
+
+	RoadDistances() = default;
+
+	//Резервирует место под count расстояний
+	void Reserve(size_t count);
+
+	//Задает расстояние от остановки from до остановки to
+	void Set(StopId from, StopId to, int distance);
+
+	//Возвращает расстояние от from до to без учета обратного направления
+	std::optional<int> Find(StopId from, StopId to) const;
+
+	//Возвращает расстояние от from до to, а если его нет - от to до from
+	std::optional<int> Get(StopId from, StopId to) const;
+
+	size_t size() const;
+
+	//Память таблицы в байтах
+	size_t GetMemoryUsage() const;
+
+	ConstIterator begin() const;
+	ConstIterator end() const;
+
+private:
+	static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+	static constexpr size_t MIN_CAPACITY = 16;
+
+	static uint64_t PackKey(StopId from, StopId to);
+
+	size_t FindSlot(uint64_t key) const;
+
+	//Перестраивает таблицу с емкостью capacity (степень двойки)
+	void Rehash(size_t capacity);
+
+	Slots slots_;
+	size_t size_ = 0;
+	//Сдвиг для хэширования Фибоначчи, равен 64 - log2(емкость)
+	int shift_ = 64;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -3,10 +3,14 @@
 #include "graph.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <optional>
+#include <queue>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
@@ -22,6 +26,10 @@ private:
 public:
 	explicit Router(const Graph& graph);
 
+	//Копия маршрутизатора для копии графа graph. Строки матрицы маршрутов остаются общими
+	//с исходным маршрутизатором и копируются при первом изменении
+	Router(const Router& other, const Graph& graph);
+
 	struct RouteInfo {
 		Weight weight;
 		std::vector<EdgeId> edges;
@@ -29,23 +37,56 @@ public:
 
 	std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+	//Учитывает изменения графа после построения: ребра removed_edge_ids убраны из графа,
+	//ребра added_edge_ids и новые вершины добавлены. Строки, маршруты которых проходили
+	//по убранным ребрам, строятся заново алгоритмом Дейкстры, затем маршруты пересчитываются
+	//только через концы новых ребер: O(|строки| * E log V + |концы| * V^2) вместо O(V^3)
+	void UpdateEdges(const std::vector<EdgeId>& removed_edge_ids, const std::vector<EdgeId>& added_edge_ids);
+
+	//Память матрицы маршрутов в байтах, включая строки, общие с копиями
+	size_t GetMemoryUsage() const;
+
 private:
 	struct RouteInternalData {
 		Weight weight;
 		std::optional<EdgeId> prev_edge;
 	};
-	using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+	//Маршруты из одной вершины. Строка может быть короче числа вершин: маршрутов
+	//в недостающие вершины нет
+	using RoutesRow = std::vector<std::optional<RouteInternalData>>;
+	using RoutesInternalData = std::vector<std::shared_ptr<RoutesRow>>;
+
+	const std::optional<RouteInternalData>& GetRouteInternalData(VertexId from, VertexId to) const {
+		const RoutesRow& row = *routes_internal_data_.at(from);
+		return to < row.size() ? row[to] : NO_ROUTE;
+	}
+
+	//Строка для изменения не короче min_size. Строка, общая с копиями, копируется
+	RoutesRow& GetMutableRow(VertexId from, size_t min_size) {
+		auto& row = routes_internal_data_[from];
+		if (row.use_count() > 1) {
+			row = std::make_shared<RoutesRow>(*row);
+		} else {
+			//Копия, освободившая строку в другом потоке, закончила работу с ней
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		if (row->size() < min_size) {
+			row->resize(min_size);
+		}
+		return *row;
+	}
 
 	void InitializeRoutesInternalData(const Graph& graph) {
 		const size_t vertex_count = graph.GetVertexCount();
 		for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-			routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+			RoutesRow& row = *routes_internal_data_[vertex];
+			row[vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
 			for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
 				const auto& edge = graph.GetEdge(edge_id);
 				if (edge.weight < ZERO_WEIGHT) {
 					throw std::domain_error("Edges' weights should be non-negative");
 				}
-				auto& route_internal_data = routes_internal_data_[vertex][edge.to];
+				auto& route_internal_data = row[edge.to];
 				if (!route_internal_data || route_internal_data->weight > edge.weight) {
 					route_internal_data = RouteInternalData{edge.weight, edge_id};
 				}
@@ -53,29 +94,64 @@ private:
 		}
 	}
 
-	void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-					const RouteInternalData& route_to) {
-		auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-		const Weight candidate_weight = route_from.weight + route_to.weight;
-		if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-			route_relaxing = {candidate_weight,
-							  route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+	//Маршруты из вершины from по текущему графу
+	std::shared_ptr<RoutesRow> BuildRow(VertexId from) const {
+		auto row = std::make_shared<RoutesRow>(graph_.GetVertexCount());
+		(*row)[from] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+		using QueueItem = std::pair<Weight, VertexId>;
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+		queue.push({ZERO_WEIGHT, from});
+		while (!queue.empty()) {
+			const auto [weight, vertex] = queue.top();
+			queue.pop();
+			if ((*row)[vertex]->weight < weight) {
+				continue;
+			}
+			for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+				const auto& edge = graph_.GetEdge(edge_id);
+				const Weight candidate_weight = weight + edge.weight;
+				auto& route = (*row)[edge.to];
+				if (!route || candidate_weight < route->weight) {
+					route = RouteInternalData{candidate_weight, edge_id};
+					queue.push({candidate_weight, edge.to});
+				}
+			}
 		}
+		return row;
 	}
 
 	void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
+		const RoutesRow& row_through = *routes_internal_data_[vertex_through];
 		for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-			if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-				for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-					if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-						RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+			const auto& route_from_data = GetRouteInternalData(vertex_from, vertex_through);
+			if (!route_from_data) {
+				continue;
+			}
+			const RouteInternalData route_from = *route_from_data;
+			//Строка копируется только при первом улучшении маршрута.
+			//Маршруты из vertex_through через нее же не улучшаются, поэтому row_through не меняется
+			RoutesRow* row_from = routes_internal_data_[vertex_from].get();
+			bool is_row_mutable = false;
+			for (VertexId vertex_to = 0; vertex_to < row_through.size(); ++vertex_to) {
+				if (const auto& route_to = row_through[vertex_to]) {
+					const Weight candidate_weight = route_from.weight + route_to->weight;
+					if (vertex_to < row_from->size() && (*row_from)[vertex_to]
+						&& !(candidate_weight < (*row_from)[vertex_to]->weight)) {
+						continue;
+					}
+					if (!is_row_mutable) {
+						row_from = &GetMutableRow(vertex_from, row_through.size());
+						is_row_mutable = true;
 					}
+					(*row_from)[vertex_to] = RouteInternalData{candidate_weight,
+						route_to->prev_edge ? route_to->prev_edge : route_from.prev_edge};
 				}
 			}
 		}
 	}
 
 	static constexpr Weight ZERO_WEIGHT{};
+	static inline const std::optional<RouteInternalData> NO_ROUTE{};
 	const Graph& graph_;
 	RoutesInternalData routes_internal_data_;
 };
@@ -83,21 +159,91 @@ private:
 template <typename Weight>
 Router<Weight>::Router(const Graph& graph)
 	: graph_(graph)
-	, routes_internal_data_(graph.GetVertexCount(),
-							std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
 {
+	const size_t vertex_count = graph.GetVertexCount();
+	routes_internal_data_.reserve(vertex_count);
+	for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+		routes_internal_data_.push_back(std::make_shared<RoutesRow>(vertex_count));
+	}
 	InitializeRoutesInternalData(graph);
 
-	const size_t vertex_count = graph.GetVertexCount();
 	for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
 		RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
 	}
 }
 
+template <typename Weight>
+Router<Weight>::Router(const Router& other, const Graph& graph)
+	: graph_(graph)
+	, routes_internal_data_(other.routes_internal_data_) {
+}
+
+template <typename Weight>
+void Router<Weight>::UpdateEdges(const std::vector<EdgeId>& removed_edge_ids,
+	const std::vector<EdgeId>& added_edge_ids) {
+	const size_t vertex_count = graph_.GetVertexCount();
+	routes_internal_data_.reserve(vertex_count);
+	for (VertexId vertex = routes_internal_data_.size(); vertex < vertex_count; ++vertex) {
+		routes_internal_data_.push_back(std::make_shared<RoutesRow>(vertex + 1));
+		(*routes_internal_data_.back())[vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+	}
+
+	if (!removed_edge_ids.empty()) {
+		std::vector<bool> is_removed(graph_.GetEdgeCount());
+		for (const EdgeId edge_id : removed_edge_ids) {
+			is_removed[edge_id] = true;
+		}
+		//Маршрут восстанавливается по последним ребрам маршрутов той же строки, поэтому
+		//маршрут через убранное ребро есть в строке, только если оно последнее в одном из ее маршрутов.
+		//Строка строится заново целиком, общая с копиями строка не изменяется
+		for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+			const RoutesRow& row = *routes_internal_data_[vertex_from];
+			if (std::any_of(row.begin(), row.end(), [&is_removed](const auto& route) {
+					return route && route->prev_edge && is_removed[*route->prev_edge];
+				})) {
+				routes_internal_data_[vertex_from] = BuildRow(vertex_from);
+			}
+		}
+	}
+
+	std::vector<VertexId> vertexes_through;
+	vertexes_through.reserve(added_edge_ids.size() * 2);
+	for (const EdgeId edge_id : added_edge_ids) {
+		const auto& edge = graph_.GetEdge(edge_id);
+		if (edge.weight < ZERO_WEIGHT) {
+			throw std::domain_error("Edges' weights should be non-negative");
+		}
+		const auto& route_internal_data = GetRouteInternalData(edge.from, edge.to);
+		if (!route_internal_data || route_internal_data->weight > edge.weight) {
+			GetMutableRow(edge.from, edge.to + 1)[edge.to] = RouteInternalData{edge.weight, edge_id};
+		}
+		vertexes_through.push_back(edge.from);
+		vertexes_through.push_back(edge.to);
+	}
+	//Новый кратчайший маршрут состоит из прежних кратчайших участков между концами новых ребер,
+	//поэтому достаточно шагов Флойда-Уоршелла через эти концы
+	std::sort(vertexes_through.begin(), vertexes_through.end());
+	vertexes_through.erase(std::unique(vertexes_through.begin(), vertexes_through.end()), vertexes_through.end());
+	for (const VertexId vertex_through : vertexes_through) {
+		RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+	}
+}
+
+template <typename Weight>
+size_t Router<Weight>::GetMemoryUsage() const {
+	//Блок make_shared содержит указатель на таблицу виртуальных функций и два счетчика
+	size_t bytes = routes_internal_data_.capacity() * sizeof(std::shared_ptr<RoutesRow>);
+	for (const auto& row : routes_internal_data_) {
+		bytes += sizeof(void*) + 2 * sizeof(int) + sizeof(RoutesRow)
+			+ row->capacity() * sizeof(std::optional<RouteInternalData>);
+	}
+	return bytes;
+}
+
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
 																			 VertexId to) const {
-	const auto& route_internal_data = routes_internal_data_.at(from).at(to);
+	const auto& route_internal_data = GetRouteInternalData(from, to);
 	if (!route_internal_data) {
 		return std::nullopt;
 	}
@@ -105,7 +251,7 @@ std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(Ver
 	std::vector<EdgeId> edges;
 	for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
 		 edge_id;
-		 edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+		 edge_id = GetRouteInternalData(from, graph_.GetEdge(*edge_id).from)->prev_edge)
 	{
 		edges.push_back(*edge_id);
 	}
@@ -19,68 +19,106 @@ static vector<Stop> CreateStopMessages(const TransportCatalogue& db) {
 	stop_message_list.reserve(db_stops.size());
 	for (const auto& db_stop : db_stops) {
 		Stop stop_message;
-		stop_message.set_name(db_stop.name);
-		stop_message.mutable_coordinates()->set_lat(db_stop.coordinates.lat);
-		stop_message.mutable_coordinates()->set_lng(db_stop.coordinates.lng);
+		stop_message.set_name(string{ db_stop.name });
+		const auto coordinates = db.GetStopCoordinates(db_stop.id);
+		stop_message.mutable_coordinates()->set_lat(coordinates.lat);
+		stop_message.mutable_coordinates()->set_lng(coordinates.lng);
 		stop_message_list.push_back(std::move(stop_message));
 	}
 	return stop_message_list;
 }
 
-static unordered_map<string_view, uint32_t> CreateStopAssociativity(const vector<Stop>& stops) {
-	unordered_map<string_view, uint32_t> stop_to_index;
-	for (size_t i = 0; i < stops.size(); ++i) {
-		const auto& stop_message = stops[i];
-		stop_to_index[stop_message.name()] = i;
-	}
-	return stop_to_index;
-}
-
-static vector<Bus> CreateBusMessages(const TransportCatalogue& db,
-	const unordered_map<string_view, uint32_t>& stop_to_index) {
+//Индекс остановки в сообщении DataBase совпадает с её идентификатором в справочнике
+static vector<Bus> CreateBusMessages(const TransportCatalogue& db) {
 	const auto& db_buses = db.GetBuses();
 	vector<Bus> bus_message_list;
 	bus_message_list.reserve(db_buses.size());
 	for (const auto& db_bus : db_buses) {
 		Bus bus_message;
-		bus_message.set_name(db_bus.name);
-		bus_message.set_is_round_trip(db_bus.is_roundtrip);
-		size_t stop_count = db_bus.is_roundtrip ? db_bus.stops.size() : (db_bus.stops.size() + 1) / 2;
-		for (size_t i = 0; i < stop_count; ++i) {
-			const auto db_stop = db_bus.stops[i];
-			bus_message.add_stop(stop_to_index.at(db_stop->name));
+		bus_message.set_name(string{ db_bus.name });
+		const auto& db_route = db.GetRoute(db_bus.route_id);
+		bus_message.set_is_round_trip(db_route.is_roundtrip);
+		for (const auto stop : db.GetRouteStops(db_route).GetStored()) {
+			bus_message.add_stop(stop);
+		}
+		if (db_route.has_length) {
+			bus_message.mutable_length()->set_geo(db_route.length_geo);
+			bus_message.mutable_length()->set_curv(db_route.length_curv);
 		}
 		bus_message_list.push_back(std::move(bus_message));
 	}
 	return bus_message_list;
 }
 
-static void CreateStopDistanceMessages([[out]] vector<Stop>& stops,
-	const TransportCatalogue& db, const unordered_map<string_view, uint32_t>& stop_to_index) {
+static void CreateStopDistanceMessages([[out]] vector<Stop>& stops, const TransportCatalogue& db) {
 	const auto& db_distances = db.GetDistances();
 	for (const auto& [stop_pair, distance] : db_distances) {
-		uint32_t index_from = stop_to_index.at(stop_pair.from->name);
-		uint32_t index_to = stop_to_index.at(stop_pair.to->name);
 		RoadDistance rd_message;
-		rd_message.set_destanation(index_to);
+		rd_message.set_destanation(stop_pair.to);
 		rd_message.set_distance(distance);
-		*stops[index_from].add_road_distance() = rd_message;
+		*stops[stop_pair.from].add_road_distance() = rd_message;
 	}
 }
 
+static void CreateStopGridMessage(const TransportCatalogue& db, DataBase& serialized_db) {
+	const auto& grid = db.GetStopGrid();
+	const auto& layout = grid.GetLayout();
+	auto& grid_message = *serialized_db.mutable_stop_grid();
+	grid_message.set_min_lat(layout.min_lat);
+	grid_message.set_min_lng(layout.min_lng);
+	grid_message.set_cell_lat(layout.cell_lat);
+	grid_message.set_cell_lng(layout.cell_lng);
+	grid_message.set_rows(layout.rows);
+	grid_message.set_cols(layout.cols);
+	grid_message.mutable_cell_offset()->Add(grid.GetCellOffsets().begin(), grid.GetCellOffsets().end());
+	grid_message.mutable_stop()->Add(grid.GetCellStops().begin(), grid.GetCellStops().end());
+}
+
+static void CreatePrefixIndexMessage(const TransportCatalogue& db, DataBase& serialized_db) {
+	const auto& index = db.GetPrefixIndex();
+	auto& index_message = *serialized_db.mutable_prefix_index();
+	index_message.set_data(index.GetData());
+	index_message.mutable_bucket_offset()->Add(index.GetBucketOffsets().begin(), index.GetBucketOffsets().end());
+	index_message.mutable_ref()->Add(index.GetRefs().begin(), index.GetRefs().end());
+}
+
+static void SetNameHashMessage(NameHash* hash_message, const transport_catalogue::domain::PerfectHash& hash) {
+	hash_message->mutable_seed()->Add(hash.GetSeeds().begin(), hash.GetSeeds().end());
+	hash_message->mutable_slot()->Add(hash.GetSlotValues().begin(), hash.GetSlotValues().end());
+}
+
+static void CreateNameIndexMessages(const TransportCatalogue& db, DataBase& serialized_db) {
+	SetNameHashMessage(serialized_db.mutable_stop_name_hash(), db.GetStopNameHash());
+	SetNameHashMessage(serialized_db.mutable_bus_name_hash(), db.GetBusNameHash());
+	const auto& stop_buses = db.GetStopBusIndex();
+	assert(stop_buses.IsFrozen());
+	auto& stop_buses_message = *serialized_db.mutable_stop_buses();
+	//Списки, измененные после заморозки, хранятся отдельно, поэтому CSR собирается заново
+	stop_buses_message.add_offset(0);
+	for (transport_catalogue::domain::StopId stop = 0; stop < stop_buses.GetStopCount(); ++stop) {
+		const auto buses = stop_buses.GetBuses(stop);
+		stop_buses_message.mutable_bus()->Add(buses.begin(), buses.end());
+		stop_buses_message.add_offset(stop_buses_message.bus_size());
+	}
+	stop_buses_message.mutable_bus_by_name()->Add(
+		stop_buses.GetBusesByName().begin(), stop_buses.GetBusesByName().end());
+}
+
 static void CreateTransportCatalogueMessages(
 	const TransportCatalogue& db, DataBase& serialized_db)
 {
 	vector<Stop> stop_message_list = CreateStopMessages(db);
-	unordered_map<string_view, uint32_t> stop_to_index = CreateStopAssociativity(stop_message_list);
-	CreateStopDistanceMessages(stop_message_list, db, stop_to_index);
-	vector<Bus> bus_message_list = CreateBusMessages(db, stop_to_index);
+	CreateStopDistanceMessages(stop_message_list, db);
+	vector<Bus> bus_message_list = CreateBusMessages(db);
 	for (auto& stop_message : stop_message_list) {
 		*serialized_db.add_stop() = std::move(stop_message);
 	}
 	for (auto& bus_message : bus_message_list) {
 		*serialized_db.add_bus() = std::move(bus_message);
 	}
+	CreateStopGridMessage(db, serialized_db);
+	CreatePrefixIndexMessage(db, serialized_db);
+	CreateNameIndexMessages(db, serialized_db);
 }
 
 static void SetColorMessage(Color* color_message, const svg::Color& color) {
@@ -153,48 +191,105 @@ void Serialize(
 	}
 }
 
-static unordered_map<int, string_view> AddStops(TransportCatalogue* db, const DataBase& serialized_db) {
-	unordered_map<int, string_view> index_to_stop_name;
-	const int stop_count = serialized_db.stop_size();
-	for (int i = 0; i < stop_count; ++i) {
-		const auto& stop_message = serialized_db.stop(i);
-		db->AddStop(stop_message.name(),
-			{ stop_message.coordinates().lat(), stop_message.coordinates().lng() });
-		index_to_stop_name[i] = stop_message.name();
+//Остановки добавляются по порядку, поэтому индекс сообщения становится идентификатором
+static void AddStops(TransportCatalogue* db, const DataBase& serialized_db) {
+	for (const auto& stop_message : serialized_db.stop()) {
+		db->AddStop(stop_message.name(), transport_catalogue::geo::FixedCoordinates{
+			stop_message.coordinates().lat(), stop_message.coordinates().lng() });
 	}
-	return index_to_stop_name;
 }
 
-static void SetStopDistances(TransportCatalogue* db,
-	const DataBase& serialized_db, const unordered_map<int, string_view>& index_to_stop_name) {
+static void SetStopDistances(TransportCatalogue* db, const DataBase& serialized_db) {
 	const int stop_count = serialized_db.stop_size();
-	for (const auto& stop_message : serialized_db.stop()) {
-		string_view stop_from = stop_message.name();
-		for (const auto& road_distance_message : stop_message.road_distance()) {
-			string_view stop_to = index_to_stop_name.at(road_distance_message.destanation());
-			int distance = road_distance_message.distance();
-			db->SetStopDistance(stop_from, stop_to, distance);
+	for (int stop_from = 0; stop_from < stop_count; ++stop_from) {
+		for (const auto& road_distance_message : serialized_db.stop(stop_from).road_distance()) {
+			db->SetStopDistance(static_cast<transport_catalogue::domain::StopId>(stop_from),
+				road_distance_message.destanation(), road_distance_message.distance());
 		}
 	}
 }
 
-static void AddBuses(TransportCatalogue* db,
-	const DataBase& serialized_db, const unordered_map<int, string_view>& index_to_stop_name) {
+static void AddBuses(TransportCatalogue* db, const DataBase& serialized_db) {
 	for (const auto& bus_message : serialized_db.bus()) {
-		vector<string_view> stops;
-		stops.reserve(bus_message.stop_size());
-		for (uint32_t stop_index : bus_message.stop()) {
-			stops.push_back(index_to_stop_name.at(stop_index));
-		}
+		vector<transport_catalogue::domain::StopId> stops{
+			bus_message.stop().begin(), bus_message.stop().end() };
 		db->AddBus(bus_message.name(), stops, bus_message.is_round_trip());
+		if (bus_message.has_length()) {
+			db->SetBusLength(static_cast<transport_catalogue::domain::BusId>(db->GetBuses().size() - 1),
+				bus_message.length().geo(), bus_message.length().curv());
+		}
+	}
+}
+
+//Все имена размещаются в хранилище справочника одним блоком
+static void ReserveNames(TransportCatalogue* db, const DataBase& serialized_db) {
+	size_t names_size = 0;
+	for (const auto& stop_message : serialized_db.stop()) {
+		names_size += stop_message.name().size();
+	}
+	for (const auto& bus_message : serialized_db.bus()) {
+		names_size += bus_message.name().size();
+	}
+	db->ReserveNames(names_size);
+}
+
+//Сохраненная сетка заменяет построение индекса при финализации
+static void SetStopGrid(TransportCatalogue* db, const DataBase& serialized_db) {
+	if (!serialized_db.has_stop_grid()) {
+		return;
+	}
+	const auto& grid_message = serialized_db.stop_grid();
+	transport_catalogue::domain::StopGrid::Layout layout;
+	layout.min_lat = grid_message.min_lat();
+	layout.min_lng = grid_message.min_lng();
+	layout.cell_lat = grid_message.cell_lat();
+	layout.cell_lng = grid_message.cell_lng();
+	layout.rows = grid_message.rows();
+	layout.cols = grid_message.cols();
+	db->SetStopGrid(transport_catalogue::domain::StopGrid{ layout,
+		{ grid_message.cell_offset().begin(), grid_message.cell_offset().end() },
+		{ grid_message.stop().begin(), grid_message.stop().end() } });
+}
+
+static void SetPrefixIndex(TransportCatalogue* db, const DataBase& serialized_db) {
+	if (!serialized_db.has_prefix_index()) {
+		return;
+	}
+	const auto& index_message = serialized_db.prefix_index();
+	db->SetPrefixIndex(transport_catalogue::domain::PrefixIndex{ index_message.data(),
+		{ index_message.bucket_offset().begin(), index_message.bucket_offset().end() },
+		{ index_message.ref().begin(), index_message.ref().end() } });
+}
+
+static transport_catalogue::domain::PerfectHash GetNameHash(const NameHash& hash_message) {
+	return { { hash_message.seed().begin(), hash_message.seed().end() },
+		{ hash_message.slot().begin(), hash_message.slot().end() } };
+}
+
+//Сохраненные индексы имен позволяют добавить остановки и автобусы без перестроения словарей
+static void SetNameIndexes(TransportCatalogue* db, const DataBase& serialized_db) {
+	if (!serialized_db.has_stop_name_hash() || !serialized_db.has_bus_name_hash()
+		|| !serialized_db.has_stop_buses()) {
+		return;
 	}
+	const auto& stop_buses_message = serialized_db.stop_buses();
+	db->SetNameIndexes(GetNameHash(serialized_db.stop_name_hash()), GetNameHash(serialized_db.bus_name_hash()),
+		transport_catalogue::domain::StopBusIndex{
+			{ stop_buses_message.bus().begin(), stop_buses_message.bus().end() },
+			{ stop_buses_message.offset().begin(), stop_buses_message.offset().end() },
+			{ stop_buses_message.bus_by_name().begin(), stop_buses_message.bus_by_name().end() } });
 }
 
 static TransportCatalogue DeserializeTransportCatalogue(const DataBase& serialized_db) {
 	TransportCatalogue db;
-	auto index_to_stop_name = AddStops(&db, serialized_db);
-	SetStopDistances(&db, serialized_db, index_to_stop_name);
-	AddBuses(&db, serialized_db, index_to_stop_name);
+	ReserveNames(&db, serialized_db);
+	SetNameIndexes(&db, serialized_db);
+	AddStops(&db, serialized_db);
+	SetStopDistances(&db, serialized_db);
+	AddBuses(&db, serialized_db);
+	SetStopGrid(&db, serialized_db);
+	SetPrefixIndex(&db, serialized_db);
+	db.Finalize();
 	return db;
 }
 
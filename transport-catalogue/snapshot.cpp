@@ -0,0 +1,295 @@
+#include "snapshot.h"
+#include "serialization.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace transport_snapshot {
+
+// ---------- Snapshot ------------------
+Snapshot::Snapshot(transport_catalogue::TransportCatalogue db, renderer::RenderSettings render_settings,
+	transport_router::RoutingSettings routing_settings)
+	: db_(std::move(db))
+	, renderer_(std::move(render_settings))
+	, router_(db_, routing_settings) {}
+
+std::shared_ptr<Snapshot> Snapshot::Load(const std::filesystem::path& path) {
+	if (!std::filesystem::is_regular_file(path)) {
+		return nullptr;
+	}
+	auto [db, render_settings, routing_settings] = transport_catalogue_serialize::Deserialize(path);
+	return std::make_shared<Snapshot>(std::move(db), std::move(render_settings), routing_settings);
+}
+
+Snapshot::Snapshot(transport_catalogue::TransportCatalogue db, renderer::MapRenderer renderer,
+	const transport_router::TransportRouter& router)
+	: db_(std::move(db))
+	, renderer_(std::move(renderer))
+	, router_(router, db_) {}
+
+std::shared_ptr<Snapshot> Snapshot::Fork() const {
+	return std::shared_ptr<Snapshot>(new Snapshot(db_.Fork(), renderer_, router_));
+}
+
+bool Snapshot::Apply(const CatalogueUpdate& update) {
+	using transport_catalogue::domain::StopId;
+	//Изменения проверяются до применения, чтобы не оставить справочник измененным наполовину
+	std::unordered_set<std::string_view> new_stops;
+	for (const auto& stop : update.stops) {
+		new_stops.insert(stop.name);
+	}
+	auto is_known = [this, &new_stops](std::string_view name) {
+		return new_stops.count(name) || db_.FindStopId(name);
+	};
+	for (const auto& distance : update.distances) {
+		if (!is_known(distance.from) || !is_known(distance.to)) {
+			return false;
+		}
+	}
+	for (const auto& bus : update.buses) {
+		if (!std::all_of(bus.stops.begin(), bus.stops.end(), is_known)) {
+			return false;
+		}
+	}
+
+	//Остановки, из которых могли измениться ребра автобусов: остановки прежних и новых путей
+	//измененных автобусов и остановки путей через концы измененных перегонов
+	std::vector<StopId> changed_stops;
+	std::vector<StopId> distance_stops;
+	auto add_route_stops = [this, &changed_stops](const transport_catalogue::domain::Route& route) {
+		const auto route_stops = db_.GetRouteStops(route).GetStored();
+		changed_stops.insert(changed_stops.end(), route_stops.begin(), route_stops.end());
+	};
+
+	//Положение остановки на веса ребер не влияет
+	for (const auto& stop : update.stops) {
+		if (const auto id = db_.FindStopId(stop.name)) {
+			db_.MoveStop(*id, transport_catalogue::geo::FixedCoordinates::FromCoordinates(stop.coordinates));
+		} else {
+			db_.AddStop(stop.name, stop.coordinates);
+		}
+	}
+	for (const auto& distance : update.distances) {
+		const StopId from = *db_.FindStopId(distance.from);
+		const StopId to = *db_.FindStopId(distance.to);
+		db_.SetStopDistance(from, to, distance.distance);
+		//Расстояние в одну сторону используется и для обратного направления, если оно не задано
+		distance_stops.push_back(from);
+		distance_stops.push_back(to);
+	}
+	for (const auto& bus : update.buses) {
+		std::vector<StopId> stops;
+		stops.reserve(bus.stops.size());
+		for (const auto& stop : bus.stops) {
+			stops.push_back(*db_.FindStopId(stop));
+		}
+		if (const auto id = db_.FindBusId(bus.name)) {
+			add_route_stops(db_.GetRoute(db_.GetBus(*id).route_id));
+			db_.UpdateBus(*id, stops, bus.is_roundtrip);
+		} else {
+			db_.AddBus(bus.name, stops, bus.is_roundtrip);
+		}
+		changed_stops.insert(changed_stops.end(), stops.begin(), stops.end());
+	}
+	db_.Finalize();
+
+	const auto& stop_buses = db_.GetStopBusIndex();
+	for (const StopId stop : distance_stops) {
+		for (const auto bus : stop_buses.GetBuses(stop)) {
+			add_route_stops(db_.GetRoute(db_.GetBus(bus).route_id));
+		}
+	}
+	std::sort(changed_stops.begin(), changed_stops.end());
+	changed_stops.erase(std::unique(changed_stops.begin(), changed_stops.end()), changed_stops.end());
+	router_.Update(changed_stops);
+	return true;
+}
+
+const transport_catalogue::TransportCatalogue& Snapshot::GetCatalogue() const {
+	return db_;
+}
+
+const renderer::MapRenderer& Snapshot::GetRenderer() const {
+	return renderer_;
+}
+
+const transport_router::TransportRouter& Snapshot::GetRouter() const {
+	return router_;
+}
+
+RequestHandler Snapshot::MakeRequestHandler() const {
+	return { db_, renderer_, router_ };
+}
+
+void RunScenarios(const Snapshot& base, const std::vector<CatalogueUpdate>& scenarios, size_t max_versions,
+	const std::function<void(size_t, const Snapshot&)>& handle) {
+	std::atomic<size_t> next_scenario{ 0 };
+	auto run = [&]() {
+		for (size_t scenario = next_scenario++; scenario < scenarios.size(); scenario = next_scenario++) {
+			const auto version = base.Fork();
+			if (version->Apply(scenarios[scenario])) {
+				handle(scenario, *version);
+			}
+		}
+	};
+	const size_t thread_count = std::min(std::max<size_t>(1, max_versions), scenarios.size());
+	std::vector<std::thread> threads;
+	for (size_t thread_index = 1; thread_index < thread_count; ++thread_index) {
+		threads.emplace_back(run);
+	}
+	if (thread_count > 0) {
+		run();
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+// ---------- SnapshotHolder ------------------
+SnapshotHolder::SnapshotHolder(std::shared_ptr<const Snapshot> snapshot)
+	: snapshot_(std::move(snapshot)) {}
+
+std::shared_ptr<const Snapshot> SnapshotHolder::Get() const {
+	return std::atomic_load(&snapshot_);
+}
+
+void SnapshotHolder::Publish(std::shared_ptr<const Snapshot> snapshot) {
+	std::atomic_store(&snapshot_, std::move(snapshot));
+}
+
+// ---------- LiveCatalogue ------------------
+LiveCatalogue::Copy::Copy(std::shared_ptr<Snapshot> snapshot)
+	: snapshot(std::move(snapshot)) {}
+
+LiveCatalogue::Reader::Reader(std::shared_ptr<Copy> copy)
+	: copy_(std::move(copy)) {}
+
+LiveCatalogue::Reader::Reader(Reader&& other) noexcept
+	: copy_(std::move(other.copy_)) {}
+
+LiveCatalogue::Reader& LiveCatalogue::Reader::operator=(Reader&& other) noexcept {
+	if (this != &other) {
+		Release();
+		copy_ = std::move(other.copy_);
+	}
+	return *this;
+}
+
+LiveCatalogue::Reader::~Reader() {
+	Release();
+}
+
+LiveCatalogue::Reader::operator bool() const {
+	return copy_ != nullptr;
+}
+
+const Snapshot& LiveCatalogue::Reader::operator*() const {
+	return *copy_->snapshot;
+}
+
+const Snapshot* LiveCatalogue::Reader::operator->() const {
+	return copy_->snapshot.get();
+}
+
+void LiveCatalogue::Reader::Release() {
+	if (copy_) {
+		copy_->readers.fetch_sub(1);
+		copy_.reset();
+	}
+}
+
+LiveCatalogue::LiveCatalogue(const std::filesystem::path& path) {
+	if (auto snapshot = Snapshot::Load(path)) {
+		standby_ = std::make_shared<Copy>(snapshot->Fork());
+		active_ = std::make_shared<Copy>(std::move(snapshot));
+	}
+}
+
+LiveCatalogue::Reader LiveCatalogue::Get() const {
+	while (true) {
+		auto copy = std::atomic_load(&active_);
+		if (!copy) {
+			return {};
+		}
+		copy->readers.fetch_add(1);
+		//Писатель, заменивший копию до отметки читателя, мог не увидеть ее и начать изменять копию.
+		//Тогда отметка снимается и берется новая опубликованная копия
+		if (std::atomic_load(&active_) == copy) {
+			return Reader(std::move(copy));
+		}
+		copy->readers.fetch_sub(1);
+	}
+}
+
+bool LiveCatalogue::Update(const CatalogueUpdate& update) {
+	std::lock_guard lock(update_mutex_);
+	if (!standby_ || !standby_->snapshot->Apply(update)) {
+		return false;
+	}
+	auto previous = std::atomic_exchange(&active_, std::move(standby_));
+	//Читатель отмечается до повторной проверки опубликованной копии, поэтому после замены
+	//нулевой счетчик означает, что новых читателей у прежней копии не появится
+	if (previous->readers.load() == 0) {
+		previous->snapshot->Apply(update);
+		standby_ = std::move(previous);
+	} else {
+		//Прежнюю копию освободит последний читатель
+		standby_ = std::make_shared<Copy>(std::atomic_load(&active_)->snapshot->Fork());
+	}
+	return true;
+}
+
+// ---------- SnapshotReloader ------------------
+SnapshotReloader::SnapshotReloader(SnapshotHolder& holder)
+	: holder_(holder)
+	, worker_(&SnapshotReloader::Run, this) {}
+
+SnapshotReloader::~SnapshotReloader() {
+	{
+		std::lock_guard lock(mutex_);
+		is_stopping_ = true;
+		pending_path_.reset();
+	}
+	state_changed_.notify_all();
+	worker_.join();
+}
+
+void SnapshotReloader::Reload(std::filesystem::path path) {
+	{
+		std::lock_guard lock(mutex_);
+		pending_path_ = std::move(path);
+	}
+	state_changed_.notify_all();
+}
+
+void SnapshotReloader::Wait() {
+	std::unique_lock lock(mutex_);
+	state_changed_.wait(lock, [this] { return !pending_path_ && !is_loading_; });
+}
+
+void SnapshotReloader::Run() {
+	std::unique_lock lock(mutex_);
+	while (true) {
+		state_changed_.wait(lock, [this] { return is_stopping_ || pending_path_; });
+		if (is_stopping_) {
+			return;
+		}
+		const std::filesystem::path path = std::move(*pending_path_);
+		pending_path_.reset();
+		is_loading_ = true;
+		lock.unlock();
+		//Снимок строится без блокировки: читатели продолжают работать с текущим
+		auto snapshot = Snapshot::Load(path);
+		if (snapshot) {
+			holder_.Publish(std::move(snapshot));
+		}
+		lock.lock();
+		is_loading_ = false;
+		state_changed_.notify_all();
+	}
+}
+
+}//end namespace transport_snapshot
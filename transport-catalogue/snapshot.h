@@ -0,0 +1,201 @@
+#pragma once
+
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace transport_snapshot {
+
+//Изменения справочника в течение дня
+struct CatalogueUpdate {
+	//Новая остановка или новое положение существующей
+	struct Stop {
+		std::string name;
+		transport_catalogue::geo::Coordinates coordinates{};
+	};
+	struct Distance {
+		std::string from;
+		std::string to;
+		int distance = 0;
+	};
+	//Новый автобус или новые остановки существующего
+	struct Bus {
+		std::string name;
+		std::vector<std::string> stops;
+		bool is_roundtrip = false;
+	};
+	std::vector<Stop> stops;
+	std::vector<Distance> distances;
+	std::vector<Bus> buses;
+};
+
+//Снимок базы: справочник вместе с построенными по нему маршрутизатором и рендерером.
+//Опубликованный снимок не изменяется. Маршрутизатор ссылается на справочник снимка,
+//поэтому снимок не копируется и не перемещается
+class Snapshot {
+public:
+	Snapshot(transport_catalogue::TransportCatalogue db, renderer::RenderSettings render_settings,
+		transport_router::RoutingSettings routing_settings);
+
+	Snapshot(const Snapshot&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+
+	//Загружает снимок из файла базы. Возвращает nullptr, если файла нет
+	static std::shared_ptr<Snapshot> Load(const std::filesystem::path& path);
+
+	//Применяет изменения к справочнику и перестраивает в маршрутизаторе только ребра,
+	//выходящие из остановок измененных путей и путей через измененные перегоны.
+	//Возвращает false и ничего не меняет, если расстояния или автобусы ссылаются на остановки,
+	//которых нет ни в справочнике, ни в изменениях
+	bool Apply(const CatalogueUpdate& update);
+
+	//Версия снимка для анализа изменений. Имена, страницы расстояний и строки матрицы маршрутов
+	//остаются общими со снимком и копируются только при изменении версии.
+	//Можно вызывать из нескольких потоков, пока снимок не изменяется
+	std::shared_ptr<Snapshot> Fork() const;
+
+	const transport_catalogue::TransportCatalogue& GetCatalogue() const;
+	const renderer::MapRenderer& GetRenderer() const;
+	const transport_router::TransportRouter& GetRouter() const;
+
+	//Обработчик запросов к снимку. Действителен, пока жив снимок
+	RequestHandler MakeRequestHandler() const;
+
+private:
+	Snapshot(transport_catalogue::TransportCatalogue db, renderer::MapRenderer renderer,
+		const transport_router::TransportRouter& router);
+
+	transport_catalogue::TransportCatalogue db_;
+	renderer::MapRenderer renderer_;
+	transport_router::TransportRouter router_;
+};
+
+//Проверяет сценарии изменений базы: каждый сценарий применяется к своей версии снимка base,
+//затем вызывается handle(номер сценария, версия). Для сценария, который нельзя применить
+//из-за неизвестных остановок, handle не вызывается. Сценарии обрабатываются параллельно,
+//но одновременно существует не больше max_versions версий, поэтому память ограничена
+//базой и изменениями этих версий
+void RunScenarios(const Snapshot& base, const std::vector<CatalogueUpdate>& scenarios, size_t max_versions,
+	const std::function<void(size_t, const Snapshot&)>& handle);
+
+//Текущий снимок базы. Читатели берут ссылку на снимок и работают с ним до конца запроса,
+//новый снимок публикуется атомарной заменой (RCU): старый освобождается вместе с последним читателем
+class SnapshotHolder {
+public:
+	SnapshotHolder() = default;
+	explicit SnapshotHolder(std::shared_ptr<const Snapshot> snapshot);
+
+	SnapshotHolder(const SnapshotHolder&) = delete;
+	SnapshotHolder& operator=(const SnapshotHolder&) = delete;
+
+	std::shared_ptr<const Snapshot> Get() const;
+
+	void Publish(std::shared_ptr<const Snapshot> snapshot);
+
+private:
+	std::shared_ptr<const Snapshot> snapshot_;
+};
+
+//Справочник, изменяемый в течение дня (схема left-right). Читатели без блокировок получают
+//согласованный снимок, изменения применяются к резервной копии, которая затем публикуется.
+//Каждая копия считает своих читателей. Прежняя копия догоняет опубликованную, только если
+//читателей у нее нет, иначе она остается им, а резервной становится новая версия опубликованной
+class LiveCatalogue {
+	struct Copy {
+		explicit Copy(std::shared_ptr<Snapshot> snapshot);
+
+		std::shared_ptr<Snapshot> snapshot;
+		std::atomic<size_t> readers{ 0 };
+	};
+
+public:
+	//Снимок для чтения. Пока объект жив, его копия не изменяется
+	class Reader {
+	public:
+		Reader() = default;
+		Reader(Reader&& other) noexcept;
+		Reader& operator=(Reader&& other) noexcept;
+		~Reader();
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		explicit operator bool() const;
+		const Snapshot& operator*() const;
+		const Snapshot* operator->() const;
+
+	private:
+		friend class LiveCatalogue;
+		explicit Reader(std::shared_ptr<Copy> copy);
+
+		void Release();
+
+		std::shared_ptr<Copy> copy_;
+	};
+
+	//Загружает копию из файла базы, резервная копия - ее версия.
+	//Если файла нет, Get возвращает пустой Reader
+	explicit LiveCatalogue(const std::filesystem::path& path);
+
+	LiveCatalogue(const LiveCatalogue&) = delete;
+	LiveCatalogue& operator=(const LiveCatalogue&) = delete;
+
+	Reader Get() const;
+
+	//Применяет изменения и публикует результат. Писатели выполняются по очереди
+	//и не ждут читателей. Изменения с неизвестными остановками не применяются,
+	//тогда возвращает false
+	bool Update(const CatalogueUpdate& update);
+
+private:
+	std::mutex update_mutex_;
+	//Опубликованная копия, читается и заменяется атомарно
+	std::shared_ptr<Copy> active_;
+	//Копия, которую читатели уже не видят. Доступна только писателю
+	std::shared_ptr<Copy> standby_;
+};
+
+//Загружает снимки из файлов базы в фоновом потоке и публикует их в holder
+class SnapshotReloader {
+public:
+	explicit SnapshotReloader(SnapshotHolder& holder);
+
+	SnapshotReloader(const SnapshotReloader&) = delete;
+	SnapshotReloader& operator=(const SnapshotReloader&) = delete;
+
+	//Дожидается текущей загрузки и останавливает поток
+	~SnapshotReloader();
+
+	//Запрашивает загрузку базы из path. Запрос, загрузка которого еще не началась,
+	//заменяется новым: публикуется только последняя база
+	void Reload(std::filesystem::path path);
+
+	//Ждет, пока все запрошенные загрузки не будут завершены
+	void Wait();
+
+private:
+	void Run();
+
+	SnapshotHolder& holder_;
+	std::mutex mutex_;
+	std::condition_variable state_changed_;
+	std::optional<std::filesystem::path> pending_path_;
+	bool is_loading_ = false;
+	bool is_stopping_ = false;
+	//Поток запускается последним, когда остальные поля уже инициализированы
+	std::thread worker_;
+};
+
+}//end namespace transport_snapshot
@@ -0,0 +1,243 @@
+//Проверки снимков базы под конкурентной нагрузкой: читатели в нескольких потоках
+//сверяют ответы с ответами, полученными последовательно для каждой версии базы
+#include "serialization.h"
+#include "snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using transport_snapshot::CatalogueUpdate;
+using transport_snapshot::LiveCatalogue;
+using transport_snapshot::Snapshot;
+using transport_snapshot::SnapshotHolder;
+using transport_snapshot::SnapshotReloader;
+
+namespace {
+
+const int STOP_COUNT = 40;
+const int VERSION_COUNT = 12;
+const int READER_COUNT = 4;
+
+//Ответы снимка, по которым сверяются читатели
+struct Answer {
+	int line_length = 0;
+	double route_weight = 0;
+	size_t route_edge_count = 0;
+	size_t express_stops_count = 0;
+
+	bool operator==(const Answer& other) const {
+		return line_length == other.line_length && std::abs(route_weight - other.route_weight) < 1e-9
+			&& route_edge_count == other.route_edge_count && express_stops_count == other.express_stops_count;
+	}
+};
+
+std::atomic<int> failure_count{ 0 };
+
+void Check(bool condition, const std::string& message) {
+	if (!condition) {
+		if (failure_count++ < 10) {
+			std::cerr << "FAILED: " << message << std::endl;
+		}
+	}
+}
+
+std::string StopName(int index) {
+	return "Stop "s + std::to_string(index);
+}
+
+//Версия 0 - исходная база, версия k меняет все перегоны маршрута Line
+//и прокладывает маршрут Express через другую промежуточную остановку
+CatalogueUpdate MakeUpdate(int version) {
+	CatalogueUpdate update;
+	for (int i = 0; i + 1 < STOP_COUNT; ++i) {
+		update.distances.push_back({ StopName(i), StopName(i + 1), 1000 + 100 * version });
+	}
+	const int middle = 2 + version % (STOP_COUNT - 4);
+	update.distances.push_back({ StopName(0), StopName(middle), 500 });
+	update.distances.push_back({ StopName(middle), StopName(STOP_COUNT - 1), 500 });
+	update.buses.push_back({ "Express"s, { StopName(0), StopName(middle), StopName(STOP_COUNT - 1) }, false });
+	return update;
+}
+
+transport_router::RoutingSettings MakeRoutingSettings() {
+	return transport_router::RoutingSettings().SetBusWaitTime(2).SetBusVelocity(30);
+}
+
+//База версии 0
+std::shared_ptr<Snapshot> MakeBase() {
+	const CatalogueUpdate data = MakeUpdate(0);
+	transport_catalogue::TransportCatalogue db;
+	std::vector<std::string> line;
+	for (int i = 0; i < STOP_COUNT; ++i) {
+		db.AddStop(StopName(i), transport_catalogue::geo::Coordinates{ 55.6 + i * 0.001, 37.6 });
+		line.push_back(StopName(i));
+	}
+	for (const auto& distance : data.distances) {
+		db.SetStopDistance(distance.from, distance.to, distance.distance);
+	}
+	db.AddBus("Line"sv, line, false);
+	db.AddBus(data.buses.front().name, data.buses.front().stops, data.buses.front().is_roundtrip);
+	db.Finalize();
+	renderer::RenderSettings render_settings;
+	render_settings.width = 600;
+	render_settings.height = 400;
+	render_settings.color_palette.push_back("green"s);
+	return std::make_shared<Snapshot>(std::move(db), render_settings, MakeRoutingSettings());
+}
+
+Answer Ask(const Snapshot& snapshot) {
+	const auto& db = snapshot.GetCatalogue();
+	Answer answer;
+	answer.line_length = db.GetBusStat("Line"sv)->length_curv;
+	answer.express_stops_count = db.GetBusStat("Express"sv)->stops_count;
+	const auto route = snapshot.GetRouter().BuildRoute(StopName(0), StopName(STOP_COUNT / 2));
+	for (const auto& edge : route) {
+		answer.route_weight += edge.weight;
+	}
+	answer.route_edge_count = route.size();
+	return answer;
+}
+
+//Ответы версий по длине маршрута Line, которая у каждой версии своя
+using Expected = std::map<int, std::pair<int, Answer>>;
+
+Expected MakeExpected(const Snapshot& base) {
+	Expected expected;
+	for (int version = 0; version < VERSION_COUNT; ++version) {
+		const auto snapshot = base.Fork();
+		snapshot->Apply(MakeUpdate(version));
+		const Answer answer = Ask(*snapshot);
+		expected[answer.line_length] = { version, answer };
+	}
+	Check(expected.size() == VERSION_COUNT, "versions have distinct answers");
+	return expected;
+}
+
+//Номер версии снимка. Ответы снимка должны совпадать с ответами этой версии
+int CheckAnswer(const Snapshot& snapshot, const Expected& expected) {
+	const Answer answer = Ask(snapshot);
+	const auto it = expected.find(answer.line_length);
+	if (it == expected.end()) {
+		Check(false, "unknown line length "s + std::to_string(answer.line_length));
+		return -1;
+	}
+	Check(answer == it->second.second, "answers of version "s + std::to_string(it->second.first));
+	return it->second.first;
+}
+
+//Читатели берут снимки, пока писатель выполняет write. Версии не идут назад
+void RunReaders(const std::function<int()>& get_version, const std::function<void()>& write) {
+	std::atomic<bool> is_written{ false };
+	std::vector<std::thread> readers;
+	for (int reader = 0; reader < READER_COUNT; ++reader) {
+		readers.emplace_back([&get_version, &is_written]() {
+			int last_version = 0;
+			while (!is_written) {
+				const int version = get_version();
+				Check(version >= last_version, "version went back");
+				last_version = std::max(last_version, version);
+			}
+		});
+	}
+	write();
+	is_written = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+}
+
+//SnapshotHolder и SnapshotReloader: читатели видят целые опубликованные снимки
+void TestReload(const Snapshot& base, const Expected& expected) {
+	const auto dir = std::filesystem::temp_directory_path() / "snapshot_tests";
+	std::filesystem::create_directories(dir);
+	std::vector<std::filesystem::path> paths;
+	for (int version = 0; version < VERSION_COUNT; ++version) {
+		const auto snapshot = base.Fork();
+		snapshot->Apply(MakeUpdate(version));
+		paths.push_back(dir / ("version_"s + std::to_string(version) + ".db"s));
+		transport_catalogue_serialize::Serialize(snapshot->GetCatalogue(), snapshot->GetRenderer().GetSettings(),
+			MakeRoutingSettings(), paths.back());
+	}
+
+	SnapshotHolder holder(Snapshot::Load(paths.front()));
+	{
+		SnapshotReloader reloader(holder);
+		RunReaders([&]() { return CheckAnswer(*holder.Get(), expected); }, [&]() {
+			for (const auto& path : paths) {
+				reloader.Reload(path);
+				std::this_thread::sleep_for(1ms);
+			}
+			reloader.Wait();
+		});
+	}
+	Check(CheckAnswer(*holder.Get(), expected) == VERSION_COUNT - 1, "last reloaded version is published");
+	std::filesystem::remove_all(dir);
+}
+
+//LiveCatalogue: читатели видят версию до или после каждого изменения, но не смесь
+void TestLiveUpdate(const Snapshot& base, const Expected& expected) {
+	const auto path = std::filesystem::temp_directory_path() / "snapshot_tests_live.db";
+	transport_catalogue_serialize::Serialize(base.GetCatalogue(), base.GetRenderer().GetSettings(),
+		MakeRoutingSettings(), path);
+	LiveCatalogue live(path);
+	std::filesystem::remove(path);
+
+	//Читатель, держащий снимок во время изменений, видит исходную версию
+	const auto held = live.Get();
+	RunReaders([&]() { return CheckAnswer(*live.Get(), expected); }, [&]() {
+		for (int version = 1; version < VERSION_COUNT; ++version) {
+			Check(live.Update(MakeUpdate(version)), "update is applied");
+		}
+	});
+	Check(CheckAnswer(*held, expected) == 0, "held reader keeps its version");
+
+	CatalogueUpdate unknown_stop;
+	unknown_stop.distances.push_back({ StopName(0), "No such stop"s, 100 });
+	Check(!live.Update(unknown_stop), "update with unknown stop is rejected");
+	Check(CheckAnswer(*live.Get(), expected) == VERSION_COUNT - 1, "rejected update changes nothing");
+}
+
+//RunScenarios: версии, обработанные параллельно, совпадают с последовательным применением,
+//база при этом не меняется
+void TestScenarios(const Snapshot& base, const Expected& expected) {
+	std::vector<CatalogueUpdate> scenarios;
+	for (int version = 0; version < VERSION_COUNT; ++version) {
+		scenarios.push_back(MakeUpdate(version));
+	}
+	//Каждый сценарий записывает только свой элемент
+	std::vector<int> versions(scenarios.size(), -1);
+	transport_snapshot::RunScenarios(base, scenarios, READER_COUNT, [&](size_t scenario, const Snapshot& version) {
+		versions[scenario] = CheckAnswer(version, expected);
+	});
+	for (size_t scenario = 0; scenario < scenarios.size(); ++scenario) {
+		Check(versions[scenario] == static_cast<int>(scenario), "scenario "s + std::to_string(scenario));
+	}
+	Check(CheckAnswer(base, expected) == 0, "base is not changed by scenarios");
+}
+
+}//end namespace
+
+int main() {
+	const auto base = MakeBase();
+	const Expected expected = MakeExpected(*base);
+	TestReload(*base, expected);
+	TestLiveUpdate(*base, expected);
+	TestScenarios(*base, expected);
+	if (failure_count > 0) {
+		std::cerr << failure_count << " checks failed" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "snapshot tests passed" << std::endl;
+	return EXIT_SUCCESS;
+}
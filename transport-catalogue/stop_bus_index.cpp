@@ -0,0 +1,276 @@
+#include "stop_bus_index.h"
+#include "memory_report.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <numeric>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+StopBusIndex::StopBusIndex(std::vector<BusId> buses, std::vector<size_t> offsets,
+	std::vector<BusId> rank_to_bus)
+	: buses_(std::move(buses))
+	, offsets_(std::move(offsets))
+	, rank_to_bus_(std::move(rank_to_bus))
+	, is_frozen_(true) {
+	assert(!offsets_->empty() && offsets_->back() == buses_->size());
+	stop_count_ = offsets_->size() - 1;
+	auto& bus_rank = bus_rank_.GetMutable();
+	bus_rank.resize(rank_to_bus_->size());
+	for (uint32_t rank = 0; rank < rank_to_bus_->size(); ++rank) {
+		bus_rank[(*rank_to_bus_)[rank]] = rank;
+	}
+	BuildBitsets(0);
+}
+
+void StopBusIndex::Reserve(size_t stop_count) {
+	if (!is_frozen_) {
+		pending_.reserve(stop_count);
+	}
+}
+
+void StopBusIndex::AddStop(StopId stop) {
+	if (!is_frozen_) {
+		assert(stop == pending_.size());
+		pending_.emplace_back();
+		return;
+	}
+	if (stop < stop_count_) {
+		return;
+	}
+	//Список новой остановки пуст, в CSR его нет
+	assert(stop == stop_count_);
+	++stop_count_;
+	if (has_bitsets_) {
+		bits_.resize(stop_count_ * words_per_stop_, 0);
+	}
+}
+
+void StopBusIndex::AddBus(BusId bus, const std::vector<StopId>& stops, const PagedVector<Bus>& buses) {
+	if (!is_frozen_) {
+		for (const StopId stop : stops) {
+			assert(stop < pending_.size());
+			pending_[stop].push_back(bus);
+		}
+		return;
+	}
+	if (bus < rank_to_bus_->size()) {
+		return;
+	}
+	//Новый автобус занимает место по имени, ранги следующих за ним сдвигаются.
+	//Относительный порядок остальных автобусов не меняется, поэтому списки остаются упорядоченными
+	assert(bus == bus_rank_->size());
+	auto& rank_to_bus = rank_to_bus_.GetMutable();
+	auto& bus_rank = bus_rank_.GetMutable();
+	const auto rank_it = std::lower_bound(rank_to_bus.begin(), rank_to_bus.end(), buses[bus].name,
+		[&buses](BusId lhs, std::string_view name) { return buses[lhs].name < name; });
+	const auto first_rank = static_cast<uint32_t>(rank_it - rank_to_bus.begin());
+	rank_to_bus.insert(rank_it, bus);
+	bus_rank.push_back(0);
+	for (uint32_t rank = first_rank; rank < rank_to_bus.size(); ++rank) {
+		bus_rank[rank_to_bus[rank]] = rank;
+	}
+	if (has_bitsets_ && bus >= words_per_stop_ * WORD_BITS) {
+		BuildBitsets(std::max<size_t>(1, words_per_stop_ * 2));
+	}
+	AddBusStops(bus, stops);
+}
+
+void StopBusIndex::AddBusStops(BusId bus, const std::vector<StopId>& stops) {
+	assert(is_frozen_ && bus < bus_rank_->size());
+	auto by_rank = [&bus_rank = *bus_rank_](BusId lhs, BusId rhs) { return bus_rank[lhs] < bus_rank[rhs]; };
+	for (const StopId stop : stops) {
+		auto& stop_buses = GetChangedBuses(stop);
+		const auto it = std::lower_bound(stop_buses.begin(), stop_buses.end(), bus, by_rank);
+		if (it == stop_buses.end() || *it != bus) {
+			stop_buses.insert(it, bus);
+		}
+		SetBit(stop, bus, true);
+	}
+}
+
+void StopBusIndex::RemoveBusStops(BusId bus, const std::vector<StopId>& stops) {
+	assert(is_frozen_ && bus < bus_rank_->size());
+	auto by_rank = [&bus_rank = *bus_rank_](BusId lhs, BusId rhs) { return bus_rank[lhs] < bus_rank[rhs]; };
+	for (const StopId stop : stops) {
+		auto& stop_buses = GetChangedBuses(stop);
+		const auto it = std::lower_bound(stop_buses.begin(), stop_buses.end(), bus, by_rank);
+		if (it != stop_buses.end() && *it == bus) {
+			stop_buses.erase(it);
+		}
+		SetBit(stop, bus, false);
+	}
+}
+
+void StopBusIndex::Freeze(const PagedVector<Bus>& buses) {
+	if (is_frozen_) {
+		if (changed_->size() * CHANGED_MERGE_RATIO > stop_count_) {
+			MergeChanged();
+		}
+		return;
+	}
+	std::vector<BusId> rank_to_bus(buses.size());
+	std::iota(rank_to_bus.begin(), rank_to_bus.end(), BusId{ 0 });
+	std::sort(rank_to_bus.begin(), rank_to_bus.end(),
+		[&buses](BusId lhs, BusId rhs) { return buses[lhs].name < buses[rhs].name; });
+	std::vector<uint32_t> bus_rank(buses.size());
+	for (uint32_t rank = 0; rank < rank_to_bus.size(); ++rank) {
+		bus_rank[rank_to_bus[rank]] = rank;
+	}
+
+	stop_count_ = pending_.size();
+	size_t total = 0;
+	for (const auto& stop_buses : pending_) {
+		total += stop_buses.size();
+	}
+	std::vector<BusId> frozen_buses;
+	frozen_buses.reserve(total);
+	std::vector<size_t> offsets;
+	offsets.reserve(stop_count_ + 1);
+	offsets.push_back(0);
+	auto by_rank = [&bus_rank](BusId lhs, BusId rhs) { return bus_rank[lhs] < bus_rank[rhs]; };
+	for (auto& stop_buses : pending_) {
+		std::sort(stop_buses.begin(), stop_buses.end(), by_rank);
+		stop_buses.erase(std::unique(stop_buses.begin(), stop_buses.end()), stop_buses.end());
+		frozen_buses.insert(frozen_buses.end(), stop_buses.begin(), stop_buses.end());
+		offsets.push_back(frozen_buses.size());
+	}
+	buses_ = std::move(frozen_buses);
+	offsets_ = std::move(offsets);
+	rank_to_bus_ = std::move(rank_to_bus);
+	bus_rank_ = std::move(bus_rank);
+	pending_.clear();
+	pending_.shrink_to_fit();
+	is_frozen_ = true;
+	BuildBitsets(0);
+}
+
+void StopBusIndex::BuildBitsets(size_t min_words) {
+	words_per_stop_ = std::max(min_words, (bus_rank_->size() + WORD_BITS - 1) / WORD_BITS);
+	bits_.clear();
+	has_bitsets_ = stop_count_ * words_per_stop_ * sizeof(uint64_t) <= MAX_BITSETS_BYTES;
+	if (has_bitsets_) {
+		bits_.assign(stop_count_ * words_per_stop_, 0);
+		for (StopId stop = 0; stop < stop_count_; ++stop) {
+			for (const BusId bus : GetBuses(stop)) {
+				SetBit(stop, bus, true);
+			}
+		}
+	}
+}
+
+void StopBusIndex::SetBit(StopId stop, BusId bus, bool value) {
+	if (!has_bitsets_) {
+		return;
+	}
+	uint64_t& word = bits_.GetMutable(stop * words_per_stop_ + bus / WORD_BITS);
+	const uint64_t mask = uint64_t{ 1 } << (bus % WORD_BITS);
+	word = value ? (word | mask) : (word & ~mask);
+}
+
+void StopBusIndex::MergeChanged() {
+	std::vector<BusId> merged_buses;
+	merged_buses.reserve(buses_->size());
+	std::vector<size_t> offsets;
+	offsets.reserve(stop_count_ + 1);
+	offsets.push_back(0);
+	for (StopId stop = 0; stop < stop_count_; ++stop) {
+		const auto stop_buses = GetBuses(stop);
+		merged_buses.insert(merged_buses.end(), stop_buses.begin(), stop_buses.end());
+		offsets.push_back(merged_buses.size());
+	}
+	buses_ = std::move(merged_buses);
+	offsets_ = std::move(offsets);
+	changed_ = std::unordered_map<StopId, std::vector<BusId>>{};
+}
+
+std::vector<BusId>& StopBusIndex::GetChangedBuses(StopId stop) {
+	auto& changed = changed_.GetMutable();
+	auto it = changed.find(stop);
+	if (it == changed.end()) {
+		const auto stop_buses = GetBuses(stop);
+		it = changed.emplace(stop, std::vector<BusId>(stop_buses.begin(), stop_buses.end())).first;
+	}
+	return it->second;
+}
+
+bool StopBusIndex::IsFrozen() const {
+	return is_frozen_;
+}
+
+ranges::Range<const BusId*> StopBusIndex::GetBuses(StopId stop) const {
+	assert(is_frozen_ && stop < stop_count_);
+	if (!changed_->empty()) {
+		if (const auto it = changed_->find(stop); it != changed_->end()) {
+			return { it->second.data(), it->second.data() + it->second.size() };
+		}
+	}
+	if (stop + 1 < offsets_->size()) {
+		return { buses_->data() + (*offsets_)[stop], buses_->data() + (*offsets_)[stop + 1] };
+	}
+	return { nullptr, nullptr };
+}
+
+bool StopBusIndex::HasBuses(StopId stop) const {
+	if (is_frozen_) {
+		const auto stop_buses = GetBuses(stop);
+		return stop_buses.begin() != stop_buses.end();
+	}
+	return !pending_[stop].empty();
+}
+
+std::vector<BusId> StopBusIndex::GetCommonBuses(StopId lhs, StopId rhs) const {
+	assert(is_frozen_);
+	std::vector<BusId> result;
+	auto by_rank = [&bus_rank = *bus_rank_](BusId lhs_bus, BusId rhs_bus) {
+		return bus_rank[lhs_bus] < bus_rank[rhs_bus];
+	};
+	if (!has_bitsets_) {
+		//Битовые множества не построены: слияние упорядоченных списков
+		const auto lhs_buses = GetBuses(lhs);
+		const auto rhs_buses = GetBuses(rhs);
+		std::set_intersection(lhs_buses.begin(), lhs_buses.end(), rhs_buses.begin(), rhs_buses.end(),
+			std::back_inserter(result), by_rank);
+		return result;
+	}
+	const size_t lhs_words = lhs * words_per_stop_;
+	const size_t rhs_words = rhs * words_per_stop_;
+	for (size_t word = 0; word < words_per_stop_; ++word) {
+		uint64_t common = bits_[lhs_words + word] & bits_[rhs_words + word];
+		for (size_t bit = 0; common != 0; ++bit, common >>= 1) {
+			if (common & 1) {
+				result.push_back(static_cast<BusId>(word * WORD_BITS + bit));
+			}
+		}
+	}
+	std::sort(result.begin(), result.end(), by_rank);
+	return result;
+}
+
+size_t StopBusIndex::GetStopCount() const {
+	return is_frozen_ ? stop_count_ : pending_.size();
+}
+
+size_t StopBusIndex::GetMemoryUsage() const {
+	using namespace memory_report;
+	size_t bytes = OfVector(pending_) + OfVector(*buses_) + OfVector(*offsets_) + OfHashTable(*changed_)
+		+ OfVector(*bus_rank_) + OfVector(*rank_to_bus_) + bits_.GetMemoryUsage();
+	for (const auto& stop_buses : pending_) {
+		bytes += OfVector(stop_buses);
+	}
+	for (const auto& [stop, stop_buses] : *changed_) {
+		bytes += OfVector(stop_buses);
+	}
+	return bytes;
+}
+
+const std::vector<BusId>& StopBusIndex::GetBusesByName() const {
+	return *rank_to_bus_;
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "domain.h"
+#include "paged_vector.h"
+#include "ranges.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Автобусы, проходящие через остановки.
+//Во время загрузки списки копятся без упорядочивания, после заморозки
+//хранятся подряд (CSR) упорядоченными по имени автобуса, а если размер позволяет -
+//дополнительно битовыми множествами, где номер бита - идентификатор автобуса.
+//Изменения после заморозки затрагивают только списки измененных остановок,
+//которые хранятся отдельно от CSR и переносятся в него при повторной заморозке.
+//Копия индекса разделяет с оригиналом CSR, измененные списки, ранги
+//и страницы битовых множеств до их изменения
+class StopBusIndex {
+public:
+	StopBusIndex() = default;
+
+	//Замороженный индекс по готовым данным, например, из сериализованной базы.
+	//Покрывает остановки с идентификаторами меньше offsets.size() - 1 и автобусы
+	//с идентификаторами меньше rank_to_bus.size(): их повторное добавление ничего не меняет
+	StopBusIndex(std::vector<BusId> buses, std::vector<size_t> offsets, std::vector<BusId> rank_to_bus);
+
+	//Резервирует место под stop_count остановок
+	void Reserve(size_t stop_count);
+
+	//Добавляет остановку без автобусов
+	void AddStop(StopId stop);
+
+	//Добавляет автобус bus, проходящий через остановки stops.
+	//По именам из buses автобус получает ранг, если индекс уже заморожен
+	void AddBus(BusId bus, const std::vector<StopId>& stops, const PagedVector<Bus>& buses);
+
+	//Добавляет уже известный автобус в списки остановок stops или удаляет из них.
+	//Только после заморозки
+	void AddBusStops(BusId bus, const std::vector<StopId>& stops);
+	void RemoveBusStops(BusId bus, const std::vector<StopId>& stops);
+
+	//Упорядочивает списки по именам автобусов, удаляет повторы и строит битовые множества.
+	//Замороженный индекс переносит в CSR измененные списки, если они есть
+	//больше чем у 1 / CHANGED_MERGE_RATIO остановок
+	void Freeze(const PagedVector<Bus>& buses);
+
+	bool IsFrozen() const;
+
+	//Автобусы остановки, упорядоченные по имени. Только после заморозки,
+	//действительны до следующего изменения индекса
+	ranges::Range<const BusId*> GetBuses(StopId stop) const;
+
+	bool HasBuses(StopId stop) const;
+
+	//Автобусы, проходящие через обе остановки, упорядоченные по имени. Только после заморозки
+	std::vector<BusId> GetCommonBuses(StopId lhs, StopId rhs) const;
+
+	size_t GetStopCount() const;
+
+	//Память списков, рангов и битовых множеств в байтах
+	size_t GetMemoryUsage() const;
+
+	//Идентификаторы автобусов, упорядоченные по имени. Только после заморозки
+	const std::vector<BusId>& GetBusesByName() const;
+
+private:
+	//Предельный размер битовых множеств, при превышении пересечение ищется слиянием списков
+	static constexpr size_t MAX_BITSETS_BYTES = 16 << 20;
+	static constexpr size_t WORD_BITS = 64;
+	static constexpr size_t CHANGED_MERGE_RATIO = 8;
+
+	//Строит битовые множества по замороженным спискам, не меньше min_words слов на остановку
+	void BuildBitsets(size_t min_words);
+
+	void SetBit(StopId stop, BusId bus, bool value);
+
+	//Строит CSR по текущим спискам всех остановок и очищает измененные списки
+	void MergeChanged();
+
+	//Список остановки, изменяемый после заморозки
+	std::vector<BusId>& GetChangedBuses(StopId stop);
+
+	//Списки автобусов во время загрузки, индексируются идентификатором остановки
+	std::vector<std::vector<BusId>> pending_;
+
+	//Списки автобусов после заморозки: автобусы остановки с идентификатором id
+	//занимают полуинтервал [offsets_[id], offsets_[id + 1])
+	CopyOnWrite<std::vector<BusId>> buses_;
+	CopyOnWrite<std::vector<size_t>> offsets_ = std::vector<size_t>{ 0 };
+
+	//Списки остановок, измененные после заморозки. Заменяют списки CSR
+	CopyOnWrite<std::unordered_map<StopId, std::vector<BusId>>> changed_;
+	size_t stop_count_ = 0;
+
+	//Ранг имени автобуса по его идентификатору и обратное отображение
+	CopyOnWrite<std::vector<uint32_t>> bus_rank_;
+	CopyOnWrite<std::vector<BusId>> rank_to_bus_;
+
+	//Битовые множества остановок по words_per_stop_ слов на остановку
+	PagedVector<uint64_t> bits_;
+	size_t words_per_stop_ = 0;
+	bool has_bitsets_ = false;
+
+	bool is_frozen_ = false;
+};
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,141 @@
+#include "stop_grid.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+StopGrid::StopGrid(Layout layout, std::vector<uint32_t> cell_offsets, std::vector<StopId> cell_stops)
+	: layout_(layout)
+	, cell_offsets_(std::move(cell_offsets))
+	, cell_stops_(std::move(cell_stops)) {
+	assert(layout_.cell_lat > 0 && layout_.cell_lng > 0);
+	assert(cell_offsets_.size() == size_t{ layout_.rows } * layout_.cols + 1);
+	assert(cell_offsets_.back() == cell_stops_.size());
+	InitCellSide();
+}
+
+StopGrid StopGrid::Build(const StopsHotData& stops) {
+	const size_t stop_count = stops.size();
+	if (stop_count == 0) {
+		return {};
+	}
+	const auto [min_lat, max_lat] = std::minmax_element(stops.lat.begin(), stops.lat.end());
+	const auto [min_lng, max_lng] = std::minmax_element(stops.lng.begin(), stops.lng.end());
+	const int64_t span_lat = int64_t{ *max_lat } - *min_lat + 1;
+	const int64_t span_lng = int64_t{ *max_lng } - *min_lng + 1;
+
+	//Пропорции ячеек выбираются по размерам города в метрах, чтобы ячейки были близки к квадратам
+	const double middle_lat = (int64_t{ *max_lat } + *min_lat) / 2. / geo::FIXED_COORDINATES_SCALE;
+	const double height = static_cast<double>(span_lat);
+	const double width = std::max(1., span_lng * std::cos(middle_lat * M_PI / 180.));
+	const double cell_count = static_cast<double>(std::max<size_t>(1, stop_count / STOPS_PER_CELL));
+	const int64_t rows = std::clamp<int64_t>(std::llround(std::sqrt(cell_count * height / width)),
+		1, static_cast<int64_t>(cell_count));
+	const int64_t cols = std::max<int64_t>(1, std::llround(cell_count / rows));
+
+	Layout layout;
+	layout.min_lat = *min_lat;
+	layout.min_lng = *min_lng;
+	layout.cell_lat = static_cast<int32_t>((span_lat + rows - 1) / rows);
+	layout.cell_lng = static_cast<int32_t>((span_lng + cols - 1) / cols);
+	layout.rows = static_cast<uint32_t>(rows);
+	layout.cols = static_cast<uint32_t>(cols);
+
+	StopGrid grid;
+	grid.layout_ = layout;
+	//Сортировка подсчетом: внутри ячейки остановки упорядочены по идентификатору
+	std::vector<uint32_t> stop_cells(stop_count);
+	grid.cell_offsets_.assign(size_t{ layout.rows } * layout.cols + 1, 0);
+	for (StopId stop = 0; stop < stop_count; ++stop) {
+		stop_cells[stop] = static_cast<uint32_t>(
+			grid.GetRow(stops.lat[stop]) * layout.cols + grid.GetCol(stops.lng[stop]));
+		++grid.cell_offsets_[stop_cells[stop] + 1];
+	}
+	for (size_t cell = 1; cell < grid.cell_offsets_.size(); ++cell) {
+		grid.cell_offsets_[cell] += grid.cell_offsets_[cell - 1];
+	}
+	grid.cell_stops_.resize(stop_count);
+	std::vector<uint32_t> cell_fill{ grid.cell_offsets_.begin(), grid.cell_offsets_.end() - 1 };
+	for (StopId stop = 0; stop < stop_count; ++stop) {
+		grid.cell_stops_[cell_fill[stop_cells[stop]]++] = stop;
+	}
+	grid.InitCellSide();
+	return grid;
+}
+
+const StopGrid::Layout& StopGrid::GetLayout() const {
+	return layout_;
+}
+
+const std::vector<uint32_t>& StopGrid::GetCellOffsets() const {
+	return cell_offsets_;
+}
+
+const std::vector<StopId>& StopGrid::GetCellStops() const {
+	return cell_stops_;
+}
+
+size_t StopGrid::GetStopCount() const {
+	return cell_stops_.size();
+}
+
+bool StopGrid::Contains(geo::FixedCoordinates point) const {
+	return point.lat >= layout_.min_lat && point.lng >= layout_.min_lng
+		&& point.lat - int64_t{ layout_.min_lat } < int64_t{ layout_.cell_lat } * layout_.rows
+		&& point.lng - int64_t{ layout_.min_lng } < int64_t{ layout_.cell_lng } * layout_.cols;
+}
+
+std::vector<StopId> StopGrid::FindInBox(const StopsHotData& stops,
+	geo::FixedCoordinates min, geo::FixedCoordinates max) const {
+	std::vector<StopId> result;
+	if (cell_stops_.empty() || min.lat > max.lat || min.lng > max.lng) {
+		return result;
+	}
+	const int64_t last_row = GetRow(max.lat);
+	const int64_t last_col = GetCol(max.lng);
+	for (int64_t row = GetRow(min.lat); row <= last_row; ++row) {
+		for (int64_t col = GetCol(min.lng); col <= last_col; ++col) {
+			for (const StopId stop : GetCell(row, col)) {
+				if (stops.lat[stop] >= min.lat && stops.lat[stop] <= max.lat
+					&& stops.lng[stop] >= min.lng && stops.lng[stop] <= max.lng) {
+					result.push_back(stop);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+ranges::Range<const StopId*> StopGrid::GetCell(int64_t row, int64_t col) const {
+	const size_t cell = static_cast<size_t>(row * layout_.cols + col);
+	return { cell_stops_.data() + cell_offsets_[cell], cell_stops_.data() + cell_offsets_[cell + 1] };
+}
+
+int64_t StopGrid::GetRow(int32_t lat) const {
+	const int64_t row = (int64_t{ lat } - layout_.min_lat) / layout_.cell_lat;
+	return std::clamp<int64_t>(row, 0, int64_t{ layout_.rows } - 1);
+}
+
+int64_t StopGrid::GetCol(int32_t lng) const {
+	const int64_t col = (int64_t{ lng } - layout_.min_lng) / layout_.cell_lng;
+	return std::clamp<int64_t>(col, 0, int64_t{ layout_.cols } - 1);
+}
+
+void StopGrid::InitCellSide() {
+	static const double meters_per_degree = geo::ERTH_RADIUS * M_PI / 180.;
+	//Ширина ячейки по долготе минимальна на самой удаленной от экватора широте сетки
+	const double max_abs_lat = std::max(std::abs(int64_t{ layout_.min_lat }),
+		std::abs(int64_t{ layout_.min_lat } + int64_t{ layout_.cell_lat } * layout_.rows))
+		/ geo::FIXED_COORDINATES_SCALE;
+	const double height = layout_.cell_lat / geo::FIXED_COORDINATES_SCALE * meters_per_degree;
+	const double width = layout_.cell_lng / geo::FIXED_COORDINATES_SCALE * meters_per_degree
+		* std::cos(std::min(90., max_abs_lat) * M_PI / 180.);
+	min_cell_side_ = std::min(height, width);
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "domain.h"
+#include "geo.h"
+#include "ranges.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue {
+
+namespace domain {
+
+//Равномерная сетка над остановками для пространственных запросов.
+//Ячейки нумеруются по строкам (широта) и столбцам (долгота),
+//остановки всех ячеек хранятся подряд (CSR) в порядке номеров ячеек
+class StopGrid {
+public:
+	//Размеры сетки, координаты в единицах фиксированной точки
+	struct Layout {
+		int32_t min_lat = 0;
+		int32_t min_lng = 0;
+		int32_t cell_lat = 1;
+		int32_t cell_lng = 1;
+		uint32_t rows = 0;
+		uint32_t cols = 0;
+	};
+
+	StopGrid() = default;
+
+	//Сетка по готовым данным, например, из сериализованной базы.
+	//Остановки ячейки с номером row * cols + col занимают
+	//полуинтервал [cell_offsets[row * cols + col], cell_offsets[row * cols + col + 1])
+	StopGrid(Layout layout, std::vector<uint32_t> cell_offsets, std::vector<StopId> cell_stops);
+
+	//Строит сетку по координатам остановок, в среднем STOPS_PER_CELL остановок на ячейку
+	static StopGrid Build(const StopsHotData& stops);
+
+	const Layout& GetLayout() const;
+	const std::vector<uint32_t>& GetCellOffsets() const;
+	const std::vector<StopId>& GetCellStops() const;
+	size_t GetStopCount() const;
+
+	//Возвращает true, если точка лежит внутри сетки
+	bool Contains(geo::FixedCoordinates point) const;
+
+	//Остановки внутри прямоугольника, включая границы, в порядке ячеек
+	std::vector<StopId> FindInBox(const StopsHotData& stops,
+		geo::FixedCoordinates min, geo::FixedCoordinates max) const;
+
+	//Не более count ближайших к точке остановок на расстоянии не больше max_distance,
+	//упорядоченные по возрастанию расстояния. distance(id) - расстояние в метрах
+	//от точки до остановки. Ячейки просматриваются кольцами вокруг ячейки точки,
+	//пока нижняя граница расстояния до кольца не превысит найденное
+	template <typename DistanceFn>
+	std::vector<std::pair<StopId, double>> FindNearest(geo::FixedCoordinates point, size_t count,
+		double max_distance, DistanceFn distance) const;
+
+	//То же, но distance вызывается только для остановок, у которых нижняя оценка
+	//расстояния lower_bound(id) не превышает max_distance и найденного расстояния.
+	//Результат и отбор по max_distance определяются только distance
+	template <typename LowerBoundFn, typename DistanceFn>
+	std::vector<std::pair<StopId, double>> FindNearest(geo::FixedCoordinates point, size_t count,
+		double max_distance, LowerBoundFn lower_bound, DistanceFn distance) const;
+
+private:
+	static constexpr size_t STOPS_PER_CELL = 4;
+	//Запас для нижней границы расстояния до кольца ячеек:
+	//покрывает погрешность плоской оценки размеров ячейки
+	static constexpr double RING_DISTANCE_MARGIN = 0.9;
+
+	ranges::Range<const StopId*> GetCell(int64_t row, int64_t col) const;
+
+	//Строка и столбец ячейки, ближайшей к точке
+	int64_t GetRow(int32_t lat) const;
+	int64_t GetCol(int32_t lng) const;
+
+	//Вычисляет наименьшую сторону ячейки в метрах
+	void InitCellSide();
+
+	Layout layout_;
+	std::vector<uint32_t> cell_offsets_ = { 0 };
+	std::vector<StopId> cell_stops_;
+	double min_cell_side_ = 0;
+};
+
+template <typename DistanceFn>
+std::vector<std::pair<StopId, double>> StopGrid::FindNearest(geo::FixedCoordinates point, size_t count,
+	double max_distance, DistanceFn distance) const {
+	return FindNearest(point, count, max_distance, [](StopId) { return 0.; }, distance);
+}
+
+template <typename LowerBoundFn, typename DistanceFn>
+std::vector<std::pair<StopId, double>> StopGrid::FindNearest(geo::FixedCoordinates point, size_t count,
+	double max_distance, LowerBoundFn lower_bound, DistanceFn distance) const {
+	std::vector<std::pair<StopId, double>> nearest;
+	if (cell_stops_.empty() || count == 0) {
+		return nearest;
+	}
+	//Куча с наиболее удаленной из найденных остановок в вершине
+	auto is_closer = [](const std::pair<StopId, double>& lhs, const std::pair<StopId, double>& rhs) {
+		return std::tie(lhs.second, lhs.first) < std::tie(rhs.second, rhs.first);
+	};
+	auto visit_cell = [&](int64_t row, int64_t col) {
+		for (const StopId stop : GetCell(row, col)) {
+			const double bound = lower_bound(stop);
+			if (bound > max_distance || (nearest.size() == count && bound > nearest.front().second)) {
+				continue;
+			}
+			const std::pair<StopId, double> candidate{ stop, distance(stop) };
+			if (candidate.second > max_distance) {
+				continue;
+			}
+			if (nearest.size() < count) {
+				nearest.push_back(candidate);
+				std::push_heap(nearest.begin(), nearest.end(), is_closer);
+			} else if (is_closer(candidate, nearest.front())) {
+				std::pop_heap(nearest.begin(), nearest.end(), is_closer);
+				nearest.back() = candidate;
+				std::push_heap(nearest.begin(), nearest.end(), is_closer);
+			}
+		}
+	};
+	const int64_t rows = layout_.rows;
+	const int64_t cols = layout_.cols;
+	const int64_t center_row = GetRow(point.lat);
+	const int64_t center_col = GetCol(point.lng);
+	const int64_t max_ring = std::max(rows, cols);
+	for (int64_t ring = 0; ring < max_ring; ++ring) {
+		const double ring_distance = ring == 0 ? 0 : (ring - 1) * min_cell_side_ * RING_DISTANCE_MARGIN;
+		if (ring_distance > max_distance
+			|| (nearest.size() == count && ring_distance > nearest.front().second)) {
+			break;
+		}
+		const int64_t first_row = std::max<int64_t>(0, center_row - ring);
+		const int64_t last_row = std::min(rows - 1, center_row + ring);
+		for (int64_t row = first_row; row <= last_row; ++row) {
+			if (row == center_row - ring || row == center_row + ring) {
+				const int64_t first_col = std::max<int64_t>(0, center_col - ring);
+				const int64_t last_col = std::min(cols - 1, center_col + ring);
+				for (int64_t col = first_col; col <= last_col; ++col) {
+					visit_cell(row, col);
+				}
+			} else {
+				if (center_col - ring >= 0) {
+					visit_cell(row, center_col - ring);
+				}
+				if (ring > 0 && center_col + ring < cols) {
+					visit_cell(row, center_col + ring);
+				}
+			}
+		}
+	}
+	std::sort_heap(nearest.begin(), nearest.end(), is_closer);
+	return nearest;
+}
+
+}//end namespace domain
+
+}//end namespace transport_catalogue
@@ -1,134 +1,609 @@
 #include "transport_catalogue.h"
+#include "parallel_for.h"
 
 namespace transport_catalogue {
 using namespace std::literals;
 
+namespace {
+
+size_t CountUniqueStops(std::vector<domain::StopId> stops) {
+	std::sort(stops.begin(), stops.end());
+	return static_cast<size_t>(std::unique(stops.begin(), stops.end()) - stops.begin());
+}
+
+} //end namespace
+
 void TransportCatalogue::AddStop(const std::string_view name, geo::Coordinates coordinates) {
-	AddStop(std::string{ name }, coordinates);
+	AddStop(name, geo::FixedCoordinates::FromCoordinates(coordinates));
 }
 
-void TransportCatalogue::AddStop(std::string&& name, geo::Coordinates coordinates) {
-	Stop stop{ std::move(name), coordinates };
-	assert(!name_to_stop_.count(stop.name));
-	stops_.push_back(std::move(stop));
-	name_to_stop_[stops_.back().name] = &stops_.back();
-	stop_to_buses_[stops_.back().name];
+void TransportCatalogue::AddStop(const std::string_view name, geo::FixedCoordinates coordinates) {
+	Stop stop{ names_.Intern(name), static_cast<StopId>(stops_.size()) };
+	//Имена остановок, покрытых совершенной хэш-функцией, в словарь не добавляются.
+	//Из остановок с одинаковым именем по имени находится последняя
+	if (stop.id >= stop_name_hash_->size()) {
+		name_to_stop_.GetMutable()[stop.name] = stop.id;
+	}
+	stops_.push_back(stop);
+	assert(stop.id < stop_name_hash_->size() || FindStopId(name) == stop.id);
+	stops_hot_.Add(coordinates);
+	stop_to_buses_.AddStop(stops_.back().id);
+}
+
+TransportCatalogue TransportCatalogue::Fork() const {
+	TransportCatalogue version;
+	version.names_ = names_.Fork();
+	version.buses_ = buses_;
+	version.routes_ = routes_;
+	version.route_stops_ = route_stops_;
+	version.free_route_ids_ = free_route_ids_;
+	version.route_hash_to_id_ = route_hash_to_id_;
+	version.bus_name_hash_ = bus_name_hash_;
+	version.name_to_bus_ = name_to_bus_;
+	version.stops_ = stops_;
+	version.stops_hot_ = stops_hot_;
+	version.stop_name_hash_ = stop_name_hash_;
+	version.name_to_stop_ = name_to_stop_;
+	version.stop_to_buses_ = stop_to_buses_;
+	version.stop_pair_to_dist_ = stop_pair_to_dist_;
+	version.fast_distance_ = fast_distance_;
+	version.stop_grid_ = stop_grid_;
+	version.prefix_index_ = prefix_index_;
+	version.is_finalized_ = is_finalized_;
+	return version;
+}
+
+void TransportCatalogue::AddBulk(const CatalogueData& data) {
+	size_t names_size = 0;
+	size_t distance_count = 0;
+	for (const auto& stop : data.stops) {
+		names_size += stop.name.size();
+		distance_count += stop.road_distances.size();
+	}
+	for (const auto& bus : data.buses) {
+		names_size += bus.name.size();
+	}
+	const size_t stop_count = stops_.size() + data.stops.size();
+	const size_t bus_count = buses_.size() + data.buses.size();
+	names_.Reserve(names_size);
+	stops_hot_.Reserve(stop_count);
+	stop_to_buses_.Reserve(stop_count);
+	stops_.reserve(stop_count);
+	name_to_stop_.GetMutable().reserve(stop_count);
+	stop_pair_to_dist_.Reserve(stop_pair_to_dist_.size() + distance_count);
+	buses_.reserve(bus_count);
+	name_to_bus_.GetMutable().reserve(bus_count);
+	routes_.reserve(routes_.size() + data.buses.size());
+	route_hash_to_id_.GetMutable().reserve(routes_.size() + data.buses.size());
+
+	const StopId first_stop = static_cast<StopId>(stops_.size());
+	for (const auto& stop : data.stops) {
+		AddStop(stop.name, stop.coordinates);
+	}
+	for (size_t i = 0; i < data.stops.size(); ++i) {
+		const StopId from = first_stop + static_cast<StopId>(i);
+		for (const auto& [name_to, distance] : data.stops[i].road_distances) {
+			const auto to = FindStopId(name_to);
+			assert(to);
+			stop_pair_to_dist_.Set(from, *to, distance);
+		}
+	}
+
+	//Имена остановок разрешаются и данные путей вычисляются параллельно,
+	//а автобусы добавляются по порядку, чтобы идентификаторы и общие пути не зависели от потоков
+	struct ResolvedBus {
+		std::vector<StopId> stops;
+		size_t route_hash = 0;
+		size_t unique_stops_count = 0;
+	};
+	std::vector<ResolvedBus> resolved_buses(data.buses.size());
+	detail::ParallelFor(data.buses.size(), MIN_BUSES_PER_THREAD, [this, &data, &resolved_buses](size_t i) {
+		const auto& bus = data.buses[i];
+		auto& resolved = resolved_buses[i];
+		resolved.stops.reserve(bus.stops.size());
+		for (const auto stop : bus.stops) {
+			const auto stop_id = FindStopId(stop);
+			assert(stop_id);
+			resolved.stops.push_back(*stop_id);
+		}
+		resolved.route_hash = domain::HashRouteStops(resolved.stops.data(), resolved.stops.size(), bus.is_roundtrip);
+		resolved.unique_stops_count = CountUniqueStops(resolved.stops);
+	});
+	for (size_t i = 0; i < data.buses.size(); ++i) {
+		auto& resolved = resolved_buses[i];
+		AddBus(data.buses[i].name, resolved.stops, data.buses[i].is_roundtrip,
+			resolved.route_hash, resolved.unique_stops_count);
+		resolved.stops = {};
+	}
+}
+
+void TransportCatalogue::AddBus(const std::string_view name,
+	const std::vector<StopId>& stops, const bool is_roundtrip) {
+	assert(std::all_of(stops.begin(), stops.end(), [this](StopId stop) { return stop < stops_.size(); }));
+	AddBus(name, stops, is_roundtrip,
+		domain::HashRouteStops(stops.data(), stops.size(), is_roundtrip), CountUniqueStops(stops));
+}
+
+void TransportCatalogue::AddBus(const std::string_view name, const std::vector<StopId>& stops,
+	const bool is_roundtrip, size_t hash, size_t unique_stops_count) {
+	const size_t route_id = FindOrAddRoute(stops, is_roundtrip, hash, unique_stops_count);
+	Bus bus;
+	bus.name = names_.Intern(name);
+	bus.route_id = route_id;
+	bus.id = static_cast<BusId>(buses_.size());
+	buses_.push_back(bus);
+	routes_.GetMutable(route_id).buses.push_back(bus.id);
+	if (bus.id >= bus_name_hash_->size()) {
+		name_to_bus_.GetMutable()[bus.name] = bus.id;
+	}
+	assert(bus.id < bus_name_hash_->size() || FindBusId(name) == bus.id);
+	stop_to_buses_.AddBus(buses_.back().id, stops, buses_);
+}
+
+const domain::Route& TransportCatalogue::UpdateBus(BusId id, const std::vector<StopId>& stops,
+	const bool is_roundtrip) {
+	assert(is_finalized_ && id < buses_.size());
+	assert(std::all_of(stops.begin(), stops.end(), [this](StopId stop) { return stop < stops_.size(); }));
+	const size_t old_route_id = buses_[id].route_id;
+	const auto old_stops = GetRouteStops(routes_[old_route_id]).GetStored();
+	stop_to_buses_.RemoveBusStops(id, std::vector<StopId>(old_stops.begin(), old_stops.end()));
+	auto& old_buses = routes_.GetMutable(old_route_id).buses;
+	old_buses.erase(std::find(old_buses.begin(), old_buses.end(), id));
+	//Путь без автобусов освобождается, его номер и место остановок займет следующий новый путь
+	if (old_buses.empty()) {
+		ReleaseRoute(old_route_id);
+	}
+
+	const size_t new_route_id = FindOrAddRoute(stops, is_roundtrip,
+		domain::HashRouteStops(stops.data(), stops.size(), is_roundtrip), CountUniqueStops(stops));
+	buses_.GetMutable(id).route_id = new_route_id;
+	routes_.GetMutable(new_route_id).buses.push_back(id);
+	stop_to_buses_.AddBusStops(id, stops);
+	return routes_[new_route_id];
+}
+
+size_t TransportCatalogue::FindOrAddRoute(const std::vector<StopId>& stops, const bool is_roundtrip,
+	size_t hash, size_t unique_stops_count) {
+	const auto [same_hash_begin, same_hash_end] = route_hash_to_id_->equal_range(hash);
+	for (auto it = same_hash_begin; it != same_hash_end; ++it) {
+		const Route& candidate = routes_[it->second];
+		const auto candidate_stops = GetRouteStops(candidate).GetStored();
+		if (candidate.is_roundtrip == is_roundtrip
+			&& std::equal(candidate_stops.begin(), candidate_stops.end(), stops.begin(), stops.end())) {
+			return candidate.id;
+		}
+	}
+	Route route;
+	route.is_roundtrip = is_roundtrip;
+	route.unique_stops_count = unique_stops_count;
+	if (!free_route_ids_.empty()) {
+		route.id = free_route_ids_.back();
+		free_route_ids_.pop_back();
+		route_stops_.Set(route.id, stops.data(), stops.size());
+	} else {
+		route.id = route_stops_.Add(stops.data(), stops.size());
+		assert(route.id == routes_.size());
+		routes_.push_back({});
+	}
+	const size_t id = route.id;
+	routes_.GetMutable(id) = std::move(route);
+	route_hash_to_id_.GetMutable().emplace(hash, id);
+	return id;
+}
+
+void TransportCatalogue::ReleaseRoute(size_t id) {
+	const Route& route = routes_[id];
+	assert(route.buses.empty());
+	const auto stops = route_stops_[id];
+	auto& route_hash_to_id = route_hash_to_id_.GetMutable();
+	const auto [same_hash_begin, same_hash_end] = route_hash_to_id.equal_range(domain::HashRouteStops(
+		stops.begin(), static_cast<size_t>(stops.end() - stops.begin()), route.is_roundtrip));
+	route_hash_to_id.erase(std::find_if(same_hash_begin, same_hash_end,
+		[id](const auto& hash_to_id) { return hash_to_id.second == id; }));
+	route_stops_.Set(id, nullptr, 0);
+	//Освобожденный путь пуст, длину для него вычислять не нужно
+	Route& released = routes_.GetMutable(id);
+	released = Route{};
+	released.id = id;
+	released.has_length = true;
+	free_route_ids_.push_back(id);
+}
+
+void TransportCatalogue::ReserveNames(size_t bytes) {
+	names_.Reserve(bytes);
 }
 
 void TransportCatalogue::SetStopDistances(std::string_view name_from,
 	const std::unordered_map<std::string_view, int>& name_to_dist) {
-	auto stop_from = name_to_stop_.find(name_from);
-	assert(stop_from != name_to_stop_.end());
+	const auto stop_from = FindStopId(name_from);
+	assert(stop_from);
 	for (const auto& [name_to, distance] : name_to_dist) {
-		auto stop_to = name_to_stop_.find(name_to);
-		assert(stop_to != name_to_stop_.end());
-		stop_pair_to_dist_[{stop_from->second, stop_to->second}] = distance;
+		const auto stop_to = FindStopId(name_to);
+		assert(stop_to);
+		stop_pair_to_dist_.Set(*stop_from, *stop_to, distance);
 	}
 }
 
 void TransportCatalogue::SetStopDistance(std::string_view from, std::string_view to, int  distance) {
-	auto stop_from = name_to_stop_.find(from);
-	auto stop_to = name_to_stop_.find(to);
-	assert(stop_from != name_to_stop_.end() && stop_to != name_to_stop_.end());
-	stop_pair_to_dist_[{stop_from->second, stop_to->second}] = distance;
+	const auto stop_from = FindStopId(from);
+	const auto stop_to = FindStopId(to);
+	assert(stop_from && stop_to);
+	SetStopDistance(*stop_from, *stop_to, distance);
+}
+
+void TransportCatalogue::SetStopDistance(StopId from, StopId to, int distance) {
+	assert(from < stops_.size() && to < stops_.size());
+	stop_pair_to_dist_.Set(from, to, distance);
+	//Расстояние в одну сторону используется и для обратного направления, если оно не задано
+	if (is_finalized_) {
+		ResetRouteLengths(from);
+		ResetRouteLengths(to);
+	}
+}
+
+void TransportCatalogue::MoveStop(StopId id, geo::FixedCoordinates coordinates) {
+	assert(id < stops_.size());
+	stops_hot_.Set(id, coordinates);
+	if (is_finalized_) {
+		ResetRouteLengths(id);
+		stop_grid_ = domain::StopGrid{};
+	}
+}
+
+void TransportCatalogue::ResetRouteLengths(StopId stop) {
+	for (const BusId bus : stop_to_buses_.GetBuses(stop)) {
+		routes_.GetMutable(buses_[bus].route_id).has_length = false;
+	}
 }
 
-std::pair<double, int> TransportCatalogue::CalculateLength(const Bus& bus) const {
+std::pair<double, int> TransportCatalogue::CalculateLength(const Route& route) const {
 	double length_geo = 0;
 	int length_curv = 0;
-	auto from = bus.stops.begin();
+	//Для некольцевого пути геометрическая длина обратного направления равна прямой,
+	//поэтому считается только хранимая половина
+	const auto all_stops = GetRouteStops(route);
+	const auto stored_stops = all_stops.GetStored();
+	std::vector<geo::UnitVector> points;
+	points.reserve(all_stops.size());
+	for (const StopId stop : stored_stops) {
+		points.push_back(stops_hot_.unit_vectors[stop]);
+	}
+	std::vector<double> distances_geo(points.empty() ? 0 : points.size() - 1);
+	geo::ComputeSegmentDistances(points.data(), points.size(), distances_geo.data());
+#ifndef NDEBUG
+	//Расстояния через единичные векторы совпадают с формулой по координатам в пределах допуска
+	auto stop_it = stored_stops.begin();
+	for (size_t i = 0; i < distances_geo.size(); ++i, ++stop_it) {
+		const double exact = geo::ComputeDistance(stops_hot_.GetCoordinates(*stop_it).ToCoordinates(),
+			stops_hot_.GetCoordinates(*std::next(stop_it)).ToCoordinates());
+		assert(std::abs(distances_geo[i] - exact) <= geo::UNIT_VECTOR_DISTANCE_TOLERANCE);
+		assert(std::abs(geo::ComputeDistance(points[i], points[i + 1]) - exact) <= geo::UNIT_VECTOR_DISTANCE_TOLERANCE);
+	}
+#endif
+	for (const double distance_geo : distances_geo) {
+		length_geo += distance_geo;
+	}
+	if (!route.is_roundtrip) {
+		length_geo *= 2;
+	}
+	auto from = all_stops.begin();
 	auto to = std::next(from);
-	while (to != bus.stops.end()) {
-		length_geo += geo::ComputeDistance((*from)->coordinates, (*to)->coordinates);
-		int distance_curv = 0;
-		if (stop_pair_to_dist_.count({ *from, *to })) {
-			distance_curv = stop_pair_to_dist_.at({ *from, *to });
-		} else if (stop_pair_to_dist_.count({ *to, *from })) {
-			distance_curv = stop_pair_to_dist_.at({ *to, *from });
-		} else {
-			assert(false);
-		}
-		length_curv += distance_curv;
+	while (to < all_stops.end()) {
+		const auto distance_curv = stop_pair_to_dist_.Get(*from, *to);
+		assert(distance_curv);
+		length_curv += distance_curv.value_or(0);
 		from = to;
 		to = std::next(to);
 	}
-	if (!bus.is_roundtrip) {
-		size_t middle = bus.stops.size() / 2;
-		auto reverse = bus.stops[middle];
-		if (stop_pair_to_dist_.count({ reverse, reverse })) {
-			length_curv += stop_pair_to_dist_.at({ reverse, reverse });
-		}
+	if (!route.is_roundtrip && !all_stops.empty()) {
+		auto reverse = all_stops[all_stops.size() / 2];
+		length_curv += stop_pair_to_dist_.Find(reverse, reverse).value_or(0);
 	}
 	return { length_geo, length_curv };
 }
 
 std::optional<int> TransportCatalogue::GetStopPairDistance(
 	const std::string_view from, const std::string_view to) const {
-	if (!name_to_stop_.count(from) || !name_to_stop_.count(to)) {
+	const auto from_id = FindStopId(from);
+	const auto to_id = FindStopId(to);
+	if (!from_id || !to_id) {
 		return std::nullopt;
 	}
-	const Stop* from_p = name_to_stop_.at(from);
-	const Stop* to_p = name_to_stop_.at(to);
-	if (stop_pair_to_dist_.count({ from_p, to_p })) {
-		return std::optional<int>(stop_pair_to_dist_.at({ from_p, to_p }));
+	return GetStopPairDistance(*from_id, *to_id);
+}
+
+std::optional<int> TransportCatalogue::GetStopPairDistance(StopId from, StopId to) const {
+	return stop_pair_to_dist_.Get(from, to);
+}
+
+std::optional<domain::StopId> TransportCatalogue::FindStopId(const std::string_view name) const {
+	//Словарь проверяется первым: имя, повторно добавленное после построения хэш-функции,
+	//относится к последней остановке или автобусу
+	if (!name_to_stop_->empty()) {
+		const auto result = name_to_stop_->find(name);
+		if (result != name_to_stop_->end()) {
+			return result->second;
+		}
+	}
+	const auto hashed = stop_name_hash_->Find(name);
+	if (hashed && *hashed < stops_.size() && stops_[*hashed].name == name) {
+		return hashed;
 	}
-	if (stop_pair_to_dist_.count({ to_p, from_p })) {
-		return std::optional<int>(stop_pair_to_dist_.at({ to_p, from_p }));
+	return std::nullopt;
+}
+
+std::optional<domain::BusId> TransportCatalogue::FindBusId(const std::string_view name) const {
+	if (!name_to_bus_->empty()) {
+		const auto result = name_to_bus_->find(name);
+		if (result != name_to_bus_->end()) {
+			return result->second;
+		}
+	}
+	const auto hashed = bus_name_hash_->Find(name);
+	if (hashed && *hashed < buses_.size() && buses_[*hashed].name == name) {
+		return hashed;
 	}
 	return std::nullopt;
 }
 
+const domain::Stop& TransportCatalogue::GetStop(StopId id) const {
+	return stops_[id];
+}
+
+geo::FixedCoordinates TransportCatalogue::GetStopCoordinates(StopId id) const {
+	return stops_hot_.GetCoordinates(id);
+}
+
+const domain::StopsHotData& TransportCatalogue::GetStopsHotData() const {
+	return stops_hot_;
+}
+
+const domain::Bus& TransportCatalogue::GetBus(BusId id) const {
+	return buses_[id];
+}
+
+const domain::Route& TransportCatalogue::GetRoute(size_t id) const {
+	return routes_[id];
+}
+
+void TransportCatalogue::SetBusLength(BusId bus, double length_geo, int length_curv) {
+	Route& route = routes_.GetMutable(buses_[bus].route_id);
+	route.length_geo = length_geo;
+	route.length_curv = length_curv;
+	route.has_length = true;
+}
+
+void TransportCatalogue::SetStopGrid(domain::StopGrid grid) {
+	stop_grid_ = std::move(grid);
+}
+
+void TransportCatalogue::SetPrefixIndex(domain::PrefixIndex index) {
+	prefix_index_ = std::move(index);
+}
+
+void TransportCatalogue::SetNameIndexes(domain::PerfectHash stop_name_hash,
+	domain::PerfectHash bus_name_hash, domain::StopBusIndex stop_to_buses) {
+	assert(stops_.empty() && buses_.empty());
+	stop_name_hash_ = std::move(stop_name_hash);
+	bus_name_hash_ = std::move(bus_name_hash);
+	stop_to_buses_ = std::move(stop_to_buses);
+}
+
+void TransportCatalogue::Finalize() {
+	std::vector<Route*> routes_to_compute;
+	for (const Route& route : routes_) {
+		if (!route.has_length) {
+			routes_to_compute.push_back(&routes_.GetMutable(route.id));
+		}
+	}
+	detail::ParallelFor(routes_to_compute.size(), MIN_ROUTES_PER_THREAD, [this, &routes_to_compute](size_t i) {
+		Route& route = *routes_to_compute[i];
+		std::tie(route.length_geo, route.length_curv) = CalculateLength(route);
+		route.has_length = true;
+	});
+	std::vector<geo::Coordinates> coordinates;
+	coordinates.reserve(stops_hot_.size());
+	for (StopId id = 0; id < stops_hot_.size(); ++id) {
+		coordinates.push_back(stops_hot_.GetCoordinates(id).ToCoordinates());
+	}
+	fast_distance_ = geo::FastDistance(coordinates.begin(), coordinates.end());
+	if (stop_grid_->GetStopCount() != stops_.size()) {
+		stop_grid_ = domain::StopGrid::Build(stops_hot_);
+	}
+	if (prefix_index_->size() != stops_.size() + buses_.size()) {
+		using Kind = domain::PrefixIndex::Kind;
+		std::vector<std::pair<std::string_view, domain::PrefixIndex::Entry>> names;
+		names.reserve(stops_.size() + buses_.size());
+		for (const Stop& stop : stops_) {
+			names.push_back({ stop.name, { Kind::STOP, stop.id } });
+		}
+		for (const Bus& bus : buses_) {
+			names.push_back({ bus.name, { Kind::BUS, bus.id } });
+		}
+		prefix_index_ = domain::PrefixIndex::Build(std::move(names));
+	}
+	stop_to_buses_.Freeze(buses_);
+	//Немногие имена, добавленные после построения хэш-функции, остаются в словаре
+	if ((stop_name_hash_->size() == 0 && !stops_.empty())
+		|| name_to_stop_->size() * NAME_HASH_REBUILD_RATIO > stops_.size()) {
+		std::vector<std::string_view> names;
+		names.reserve(stops_.size());
+		for (const Stop& stop : stops_) {
+			names.push_back(stop.name);
+		}
+		//Если функцию построить не удалось, имена остаются в словаре
+		if (auto hash = domain::PerfectHash::Build(names)) {
+			stop_name_hash_ = std::move(*hash);
+			name_to_stop_ = std::unordered_map<std::string_view, StopId>{};
+		}
+	}
+	if ((bus_name_hash_->size() == 0 && !buses_.empty())
+		|| name_to_bus_->size() * NAME_HASH_REBUILD_RATIO > buses_.size()) {
+		std::vector<std::string_view> names;
+		names.reserve(buses_.size());
+		for (const Bus& bus : buses_) {
+			names.push_back(bus.name);
+		}
+		if (auto hash = domain::PerfectHash::Build(names)) {
+			bus_name_hash_ = std::move(*hash);
+			name_to_bus_ = std::unordered_map<std::string_view, BusId>{};
+		}
+	}
+	is_finalized_ = true;
+}
+
+const domain::PerfectHash& TransportCatalogue::GetStopNameHash() const {
+	return *stop_name_hash_;
+}
+
+const domain::PerfectHash& TransportCatalogue::GetBusNameHash() const {
+	return *bus_name_hash_;
+}
+
+const domain::StopBusIndex& TransportCatalogue::GetStopBusIndex() const {
+	return stop_to_buses_;
+}
+
+const domain::StopGrid& TransportCatalogue::GetStopGrid() const {
+	return *stop_grid_;
+}
+
+std::vector<std::pair<domain::StopId, double>> TransportCatalogue::FindNearestStops(
+	geo::Coordinates point, size_t count, double max_distance) const {
+	const auto fixed_point = geo::FixedCoordinates::FromCoordinates(point);
+	const auto point_vector = geo::ToUnitVector(point);
+	auto distance = [this, &point_vector](StopId stop) {
+		return geo::ComputeDistance(point_vector, stops_hot_.unit_vectors[stop]);
+	};
+	//Приближенная метрика только отсекает заведомо далекие остановки
+	//и пригодна лишь для точек города, расстояния в ответе точные
+	if (fast_distance_.IsAccurate() && stop_grid_->Contains(fixed_point)) {
+		return stop_grid_->FindNearest(fixed_point, count, max_distance, [this, point](StopId stop) {
+			return fast_distance_.LowerBound(point, stops_hot_.GetCoordinates(stop).ToCoordinates());
+		}, distance);
+	}
+	return stop_grid_->FindNearest(fixed_point, count, max_distance, distance);
+}
+
+std::vector<domain::StopId> TransportCatalogue::FindStopsInBox(geo::Coordinates min, geo::Coordinates max) const {
+	return stop_grid_->FindInBox(stops_hot_,
+		geo::FixedCoordinates::FromCoordinates(min), geo::FixedCoordinates::FromCoordinates(max));
+}
+
+const domain::PrefixIndex& TransportCatalogue::GetPrefixIndex() const {
+	return *prefix_index_;
+}
+
+std::vector<domain::PrefixIndex::Entry> TransportCatalogue::FindByPrefix(
+	std::string_view prefix, size_t limit) const {
+	return prefix_index_->FindByPrefix(prefix, limit);
+}
+
 std::optional<domain::BusStat> TransportCatalogue::GetBusStat(const std::string_view name) const {
-	const auto result = name_to_bus_.find(name);
-	if (result == name_to_bus_.end()) {
+	const auto bus_id = FindBusId(name);
+	if (!bus_id) {
 		return std::optional<domain::BusStat>();
 	}
-	size_t stops_count = result->second->stops.size();
-	size_t unique_stops_count = result->second->unique_stops_count;
-	const auto [length_geo, length_curv] = CalculateLength(*(result->second));
-	return std::optional<domain::BusStat>(
-		{ result->first, stops_count, unique_stops_count, length_geo, length_curv });
+	return GetBusStat(*bus_id);
+}
+
+domain::BusStat TransportCatalogue::GetBusStat(BusId id) const {
+	const Bus& bus = buses_[id];
+	const Route& route = routes_[bus.route_id];
+	size_t stops_count = GetRouteStops(route).size();
+	size_t unique_stops_count = route.unique_stops_count;
+	if (route.has_length) {
+		return { bus.name, stops_count, unique_stops_count, route.length_geo, route.length_curv };
+	}
+	const auto [length_geo, length_curv] = CalculateLength(route);
+	return { bus.name, stops_count, unique_stops_count, length_geo, length_curv };
 }
 
 size_t TransportCatalogue::GetStopCount() const {
 	return stops_.size();
 }
 
-const std::unordered_map<domain::StopPair, int, domain::StopPairHasher>& 
-TransportCatalogue::GetDistances() const {
+const domain::RoadDistances& TransportCatalogue::GetDistances() const {
 	return stop_pair_to_dist_;
 }
 
 std::optional<domain::StopStat> TransportCatalogue::GetStopStat(const std::string_view name) const {
-	const auto result = stop_to_buses_.find(name);
-	if (result == stop_to_buses_.end()) {
-		static const std::set<std::string_view> empty_result;
+	const auto stop_id = FindStopId(name);
+	if (!stop_id) {
 		return std::optional<domain::StopStat>();
 	}
-	return std::optional<domain::StopStat>({ result->first, result->second });
+	return GetStopStat(*stop_id);
+}
+
+domain::StopStat TransportCatalogue::GetStopStat(StopId id) const {
+	return { stops_[id].name, stop_to_buses_.GetBuses(id) };
+}
+
+std::optional<std::vector<domain::BusId>> TransportCatalogue::GetCommonBuses(
+	const std::string_view lhs, const std::string_view rhs) const {
+	const auto lhs_id = FindStopId(lhs);
+	const auto rhs_id = FindStopId(rhs);
+	if (!lhs_id || !rhs_id) {
+		return std::nullopt;
+	}
+	return GetCommonBuses(*lhs_id, *rhs_id);
+}
+
+std::vector<domain::BusId> TransportCatalogue::GetCommonBuses(StopId lhs, StopId rhs) const {
+	return stop_to_buses_.GetCommonBuses(lhs, rhs);
 }
 
-const std::deque <domain::Bus>& TransportCatalogue::GetBuses() const{
+const domain::PagedVector<domain::Bus>& TransportCatalogue::GetBuses() const{
 	return buses_;
 }
 
-const std::deque <domain::Stop>& TransportCatalogue::GetStops() const {
+const domain::PagedVector<domain::Route>& TransportCatalogue::GetRoutes() const {
+	return routes_;
+}
+
+domain::RouteStopsView TransportCatalogue::GetRouteStops(const Route& route) const {
+	const auto stops = route_stops_[route.id];
+	return { stops.begin(), static_cast<size_t>(stops.end() - stops.begin()), route.is_roundtrip };
+}
+
+const domain::PagedVector<domain::Stop>& TransportCatalogue::GetStops() const {
 	return stops_;
 }
 
 std::vector<const domain::Stop*> TransportCatalogue::GetStopsUsed() const {
 	std::vector<const domain::Stop*> stops;
-	stops.reserve(stop_to_buses_.size());
-	for (const auto& [stop, buses] : stop_to_buses_) {
-		if (!buses.empty()) {
-			stops.push_back(name_to_stop_.at(stop));
+	stops.reserve(stops_.size());
+	for (StopId id = 0; id < stops_.size(); ++id) {
+		if (stop_to_buses_.HasBuses(id)) {
+			stops.push_back(&stops_[id]);
 		}
 	}
 	return stops;
 }
 
-namespace detail {
-
-} //end namespace detail
+void TransportCatalogue::ReportMemory(memory_report::Report& report) const {
+	using namespace memory_report;
+	size_t routes_bytes = routes_.GetMemoryUsage();
+	for (const auto& route : routes_) {
+		routes_bytes += OfVector(route.buses);
+	}
+	report.Add("names_", names_.GetMemoryUsage())
+		.Add("stops_", stops_.GetMemoryUsage())
+		.Add("stops_hot_", stops_hot_.lat.GetMemoryUsage() + stops_hot_.lng.GetMemoryUsage()
+			+ stops_hot_.unit_vectors.GetMemoryUsage())
+		.Add("buses_", buses_.GetMemoryUsage())
+		.Add("routes_", routes_bytes)
+		.Add("route_stops_", route_stops_.GetMemoryUsage())
+		.Add("route_hash_to_id_", OfHashTable(*route_hash_to_id_))
+		.Add("bus_name_hash_", OfVector(bus_name_hash_->GetSeeds()) + OfVector(bus_name_hash_->GetSlotValues()))
+		.Add("name_to_bus_", OfHashTable(*name_to_bus_))
+		.Add("stop_name_hash_", OfVector(stop_name_hash_->GetSeeds()) + OfVector(stop_name_hash_->GetSlotValues()))
+		.Add("name_to_stop_", OfHashTable(*name_to_stop_))
+		.Add("stop_to_buses_", stop_to_buses_.GetMemoryUsage())
+		.Add("stop_pair_to_dist_", stop_pair_to_dist_.GetMemoryUsage())
+		.Add("stop_grid_", OfVector(stop_grid_->GetCellOffsets()) + OfVector(stop_grid_->GetCellStops()))
+		.Add("prefix_index_", OfString(prefix_index_->GetData()) + OfVector(prefix_index_->GetBucketOffsets())
+			+ OfVector(prefix_index_->GetRefs()));
+}
 
-} //end namespace transport_catalogue
\ No newline at end of file
+} //end namespace transport_catalogue
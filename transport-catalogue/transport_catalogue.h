@@ -2,117 +2,283 @@
 
 #include "domain.h"
 #include "geo.h"
+#include "memory_report.h"
+#include "name_arena.h"
+#include "perfect_hash.h"
+#include "prefix_index.h"
+#include "road_distances.h"
+#include "stop_bus_index.h"
+#include "stop_grid.h"
 
 #include <algorithm>
 #include <cassert>
-#include <deque>
 #include <functional>
+#include <limits>
 #include <optional>
-#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace transport_catalogue {
 
+//Данные для массовой загрузки справочника
+struct CatalogueData {
+	struct Stop {
+		std::string_view name;
+		geo::Coordinates coordinates{};
+		//Расстояния по дорогам до других остановок
+		std::unordered_map<std::string_view, int> road_distances;
+	};
+	struct Bus {
+		std::string_view name;
+		std::vector<std::string_view> stops;
+		bool is_roundtrip = false;
+	};
+	std::vector<Stop> stops;
+	std::vector<Bus> buses;
+};
+
 class TransportCatalogue {
 
 using Bus = domain::Bus;
+using BusId = domain::BusId;
+using Route = domain::Route;
 using Stop = domain::Stop;
-using StopPair = domain::StopPair;
-using StopPairHasher = domain::StopPairHasher;
+using StopId = domain::StopId;
+using RoadDistances = domain::RoadDistances;
 
 public:
 	TransportCatalogue() = default;
 
+	TransportCatalogue(TransportCatalogue&&) = default;
+	TransportCatalogue& operator=(TransportCatalogue&&) = default;
+
+	//Независимая версия справочника для анализа изменений. Все хранилища и индексы остаются
+	//общими с исходным справочником: страницы копируются при их изменении, индексы,
+	//которые строятся целиком, - при перестроении. Стоит O(размер / размер страницы)
+	TransportCatalogue Fork() const;
+
 	template<typename StringType>
-	void AddBus(const std::string_view name, const std::vector<StringType>& stop,
+	void AddBus(const std::string_view name, const std::vector<StringType>& stops,
 		const bool is_roundtrip);
-	template<typename StringType>
-	void AddBus(std::string&& name, const std::vector<StringType>& stops,
+	void AddBus(const std::string_view name, const std::vector<StopId>& stops,
 		const bool is_roundtrip);
 
 	void AddStop(const std::string_view name, geo::Coordinates coordinates);
-	void AddStop(std::string&& name, geo::Coordinates coordinates);
+	void AddStop(const std::string_view name, geo::FixedCoordinates coordinates);
+
+	//Добавляет все остановки, расстояния и автобусы разом. Места в контейнерах резервируются
+	//заранее, остановки автобусов и данные путей вычисляются параллельно,
+	//идентификаторы назначаются в порядке data
+	void AddBulk(const CatalogueData& data);
+
+	//Резервирует место под имена остановок и автобусов суммарной длиной bytes
+	void ReserveNames(size_t bytes);
 
 	//Добавляет информацию о расстояниях между остановками
 	void SetStopDistances(std::string_view name,
 		const std::unordered_map<std::string_view, int>& name_to_dist);
 
-	//Добавляет информацию о расстояниях между двумя остановками
+	//Добавляет информацию о расстояниях между двумя остановками.
+	//После финализации сбрасывает длины путей через эти остановки
 	void SetStopDistance(std::string_view from, std::string_view to, int  distance);
+	void SetStopDistance(StopId from, StopId to, int distance);
 
 	std::optional<int> GetStopPairDistance(const std::string_view from, const std::string_view to) const;
+	std::optional<int> GetStopPairDistance(StopId from, StopId to) const;
+
+	//Возвращает идентификатор остановки или автобуса по имени
+	std::optional<StopId> FindStopId(const std::string_view name) const;
+	std::optional<BusId> FindBusId(const std::string_view name) const;
+
+	const Stop& GetStop(StopId id) const;
+	geo::FixedCoordinates GetStopCoordinates(StopId id) const;
+
+	//Координаты остановок в параллельных массивах, индексируются идентификатором остановки
+	const domain::StopsHotData& GetStopsHotData() const;
+	const Bus& GetBus(BusId id) const;
+	const Route& GetRoute(size_t id) const;
+
+	//Задает длины пути автобуса, вычисленные заранее (например, при сериализации)
+	void SetBusLength(BusId bus, double length_geo, int length_curv);
+
+	//Задает пространственный индекс остановок, построенный заранее (например, при сериализации)
+	void SetStopGrid(domain::StopGrid grid);
+
+	//Задает индекс имен для поиска по префиксу, построенный заранее
+	void SetPrefixIndex(domain::PrefixIndex index);
+
+	//Задает построенные заранее совершенные хэш-функции имен и списки автобусов остановок.
+	//Вызывается до добавления остановок и автобусов: покрытые ими остановки и автобусы
+	//добавляются без перестроения словарей и списков
+	void SetNameIndexes(domain::PerfectHash stop_name_hash, domain::PerfectHash bus_name_hash,
+		domain::StopBusIndex stop_to_buses);
+
+	//Переносит остановку в новую точку. После финализации сбрасывает длины путей
+	//через остановку и пространственный индекс
+	void MoveStop(StopId id, geo::FixedCoordinates coordinates);
+
+	//Заменяет остановки автобуса, меняя только списки автобусов затронутых остановок.
+	//Прежний путь, по которому больше не следует ни один автобус, освобождается
+	//и используется заново для следующего нового пути.
+	//Только после финализации, возвращает новый путь автобуса
+	const Route& UpdateBus(BusId id, const std::vector<StopId>& stops, const bool is_roundtrip);
+
+	//Вычисляет длины всех путей, для которых они еще не заданы,
+	//строит приближенную метрику расстояний для города, пространственный индекс остановок,
+	//индексы имен, если они не заданы или не покрывают многие имена, и замораживает
+	//списки автобусов остановок. Вызывается после загрузки и после изменений справочника,
+	//пути обрабатываются параллельно
+	void Finalize();
+
+	//Индексы имен и списки автобусов остановок, строятся при финализации
+	const domain::PerfectHash& GetStopNameHash() const;
+	const domain::PerfectHash& GetBusNameHash() const;
+	const domain::StopBusIndex& GetStopBusIndex() const;
+
+	//Пространственный индекс остановок, строится при финализации
+	const domain::StopGrid& GetStopGrid() const;
+
+	//Не более count ближайших к точке остановок на расстоянии не больше max_distance метров,
+	//упорядоченные по возрастанию расстояния. Доступно после финализации
+	std::vector<std::pair<StopId, double>> FindNearestStops(geo::Coordinates point, size_t count,
+		double max_distance = std::numeric_limits<double>::infinity()) const;
+
+	//Остановки внутри прямоугольника координат, включая границы. Доступно после финализации
+	std::vector<StopId> FindStopsInBox(geo::Coordinates min, geo::Coordinates max) const;
+
+	//Индекс имен остановок и автобусов, строится при финализации
+	const domain::PrefixIndex& GetPrefixIndex() const;
+
+	//Не более limit остановок и автобусов с именами, начинающимися с prefix,
+	//в порядке имен. Доступно после финализации
+	std::vector<domain::PrefixIndex::Entry> FindByPrefix(std::string_view prefix, size_t limit) const;
 
 	std::optional<domain::BusStat> GetBusStat(const std::string_view name) const;
+	domain::BusStat GetBusStat(BusId id) const;
 
+	//Список автобусов остановки доступен после финализации
 	std::optional<domain::StopStat> GetStopStat(const std::string_view name) const;
+	domain::StopStat GetStopStat(StopId id) const;
+
+	//Автобусы, проходящие через обе остановки, упорядоченные по имени. Доступно после финализации
+	std::optional<std::vector<BusId>> GetCommonBuses(const std::string_view lhs, const std::string_view rhs) const;
+	std::vector<BusId> GetCommonBuses(StopId lhs, StopId rhs) const;
+
+	//Автобусы, упорядоченные по идентификатору
+	const domain::PagedVector<Bus>& GetBuses() const;
 
-	const std::deque<Bus>& GetBuses() const;
+	//Возвращает уникальные пути следования, общие для автобусов с одинаковыми остановками.
+	//Освобожденные пути остаются на своих местах без автобусов и остановок
+	const domain::PagedVector<Route>& GetRoutes() const;
 
-	const std::deque<Stop>& GetStops() const;
+	//Возвращает полную последовательность остановок пути.
+	//Действительна, пока в справочнике не добавляются и не изменяются автобусы
+	domain::RouteStopsView GetRouteStops(const Route& route) const;
+
+	//Остановки, упорядоченные по идентификатору
+	const domain::PagedVector<Stop>& GetStops() const;
 
 	std::vector<const Stop*> GetStopsUsed() const;
 
 	size_t GetStopCount() const;
 
-	const std::unordered_map<StopPair, int, StopPairHasher>& GetDistances() const;
+	const RoadDistances& GetDistances() const;
+
+	//Добавляет в отчет объем памяти хранилищ и индексов справочника
+	void ReportMemory(memory_report::Report& report) const;
 
 private:
+	//Минимальное число путей на поток при финализации
+	static const size_t MIN_ROUTES_PER_THREAD = 64;
+	//Минимальное число автобусов на поток при массовой загрузке
+	static const size_t MIN_BUSES_PER_THREAD = 256;
+	//Хэш-функция имен перестраивается при финализации, если словарь непокрытых имен
+	//содержит больше 1 / NAME_HASH_REBUILD_RATIO имен
+	static const size_t NAME_HASH_REBUILD_RATIO = 8;
+
+	//Добавляет автобус по остановкам с заранее вычисленными хэшем пути и числом уникальных остановок
+	void AddBus(const std::string_view name, const std::vector<StopId>& stops, const bool is_roundtrip,
+		size_t route_hash, size_t unique_stops_count);
+
+	//Находит путь с такими же остановками или добавляет новый, возвращает его номер
+	size_t FindOrAddRoute(const std::vector<StopId>& stops, const bool is_roundtrip,
+		size_t route_hash, size_t unique_stops_count);
+
+	//Удаляет путь без автобусов из поиска по хэшу, освобождает его остановки и номер
+	void ReleaseRoute(size_t id);
+
+	//Сбрасывает длины путей, проходящих через остановку
+	void ResetRouteLengths(StopId stop);
 
-	std::pair<double, int> CalculateLength(const Bus& bus) const;
+	std::pair<double, int> CalculateLength(const Route& route) const;
+
+	//Хранилище имен остановок и автобусов
+	domain::NameArena names_;
 
 	//Контейнер автобусов (маршрутов)
-	std::deque <Bus> buses_;
+	domain::PagedVector<Bus> buses_;
+
+	//Контейнер уникальных путей следования
+	domain::PagedVector<Route> routes_;
+
+	//Хранимые остановки путей, индексируются номером пути.
+	//Остановки одного пути лежат подряд, страницы общие с версиями справочника
+	domain::PagedSequences<StopId> route_stops_;
+
+	//Номера освобожденных путей для повторного использования
+	std::vector<size_t> free_route_ids_;
+
+	//Контейнер для поиска уже существующего пути следования по хэшу остановок
+	domain::CopyOnWrite<std::unordered_multimap<size_t, size_t>> route_hash_to_id_;
+
+	//Совершенная хэш-функция имен автобусов, строится при финализации
+	domain::CopyOnWrite<domain::PerfectHash> bus_name_hash_;
 
-	//Контейнер для быстрого доступа к автобусам (маршрутам) по имени
-	std::unordered_map<std::string_view, const Bus*> name_to_bus_;
+	//Контейнер для быстрого доступа по имени к автобусам (маршрутам), не покрытым bus_name_hash_
+	domain::CopyOnWrite<std::unordered_map<std::string_view, BusId>> name_to_bus_;
 
 	//Контейнер остановок
-	std::deque <Stop> stops_;
+	domain::PagedVector<Stop> stops_;
 
-	//Контейнер для быстрого доступа к остановкам по имени
-	std::unordered_map<std::string_view, const Stop*> name_to_stop_;
+	//Координаты остановок, индексируются идентификатором остановки
+	domain::StopsHotData stops_hot_;
 
-	//Контенер для хранения информации об автобусах, проходящих через остановку
-	std::unordered_map<std::string_view, std::set<std::string_view>> stop_to_buses_;
+	//Совершенная хэш-функция имен остановок, строится при финализации
+	domain::CopyOnWrite<domain::PerfectHash> stop_name_hash_;
+
+	//Контейнер для быстрого доступа по имени к остановкам, не покрытым stop_name_hash_
+	domain::CopyOnWrite<std::unordered_map<std::string_view, StopId>> name_to_stop_;
+
+	//Автобусы, проходящие через остановку, индексируются идентификатором остановки
+	domain::StopBusIndex stop_to_buses_;
 
 	//Контенер для хранения расстояний между остановками
-	std::unordered_map<StopPair, int, StopPairHasher> stop_pair_to_dist_;
+	RoadDistances stop_pair_to_dist_;
+
+	//Приближенная метрика расстояний в пределах города
+	geo::FastDistance fast_distance_;
+
+	//Пространственный индекс остановок
+	domain::CopyOnWrite<domain::StopGrid> stop_grid_;
+
+	//Индекс имен для поиска по префиксу
+	domain::CopyOnWrite<domain::PrefixIndex> prefix_index_;
+
+	bool is_finalized_ = false;
 };
 
 template<typename StringType>
 void TransportCatalogue::AddBus(const std::string_view name,
 	const std::vector<StringType>& stops, const bool is_roundtrip) {
-	AddBus(std::string{ name }, stops, is_roundtrip);
-}
-template<typename StringType>
-void TransportCatalogue::AddBus(std::string&& name,
-	const std::vector<StringType>& stops, const bool is_roundtrip) {
-	Bus bus;
-	bus.name = std::move(name);
-	bus.is_roundtrip = is_roundtrip;
-	bus.stops.reserve(stops.size() + stops.size() * (!is_roundtrip));
-	std::unordered_set<std::string_view> unique_stops;
-	for (const auto& stop : stops) {
-		assert(name_to_stop_.count(stop));
-		bus.stops.push_back(name_to_stop_.at(stop));
-		unique_stops.insert(stop);
-	}
-	bus.unique_stops_count = unique_stops.size();
-	if (!is_roundtrip) {
-		bus.stops.resize(stops.size() * 2 - 1);
-		std::reverse_copy(bus.stops.begin(),
-			std::next(bus.stops.begin(), stops.size() - 1),
-			std::next(bus.stops.begin(), stops.size())
-		);
-	}
-	buses_.push_back(std::move(bus));
-	name_to_bus_[buses_.back().name] = &buses_.back();
+	std::vector<StopId> stop_ids;
+	stop_ids.reserve(stops.size());
 	for (const auto& stop : stops) {
-		stop_to_buses_.at(stop).insert(buses_.back().name);
+		const auto stop_id = FindStopId(stop);
+		assert(stop_id);
+		stop_ids.push_back(*stop_id);
 	}
+	AddBus(name, stop_ids, is_roundtrip);
 }
 
 } //end namespace transport_catalogue
\ No newline at end of file
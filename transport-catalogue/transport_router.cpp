@@ -1,5 +1,7 @@
 #include "transport_router.h"
 
+#include <algorithm>
+
 static const double TIME_UNITS_COEFF = 60. / 1000;
 
 namespace transport_router {
@@ -11,76 +13,224 @@ TransportRouter::TransportRouter(const transport_catalogue::TransportCatalogue&
 	BuildRouter();
 }
 
+TransportRouter::TransportRouter(const TransportRouter& other, const transport_catalogue::TransportCatalogue& db)
+	: db_(db)
+	, graph_(other.graph_)
+	, router_(std::make_unique<Router>(*other.router_, graph_))
+	, settings_(other.settings_)
+	, stop_to_vertexes_(other.stop_to_vertexes_)
+	, edge_records_(other.edge_records_)
+	, current_vertex_count_(other.current_vertex_count_) {
+}
+
 void TransportRouter::BuildRouter() {
-	AddStopsToGraph();
-	AddBusesToGraph();
+	std::vector<EdgeId> added_edges;
+	AddStopsToGraph(added_edges);
+	AddRoutesToGraph();
 	router_ = std::make_unique<Router>(graph_);
 }
 
-void TransportRouter::AddStopsToGraph() {
+void TransportRouter::Update(const std::vector<StopId>& stops) {
+	std::vector<EdgeId> removed_edges;
+	std::vector<EdgeId> added_edges;
+	AddStopsToGraph(added_edges);
+	for (const StopId stop : stops) {
+		RebuildStopEdges(stop, removed_edges, added_edges);
+	}
+	router_->UpdateEdges(removed_edges, added_edges);
+}
+
+void TransportRouter::AddStopsToGraph(std::vector<EdgeId>& added_edges) {
 	const auto& stops = db_.GetStops();
-	for (const auto& stop : stops) {
+	if (stop_to_vertexes_.size() == stops.size()) {
+		return;
+	}
+	if (graph_.GetVertexCount() < stops.size() * 2) {
+		graph_.AddVertexes(stops.size() * 2 - graph_.GetVertexCount());
+	}
+	stop_to_vertexes_.reserve(stops.size());
+	for (auto stop = std::next(stops.begin(), stop_to_vertexes_.size()); stop != stops.end(); ++stop) {
 		VertexId wait_id = GetNextVertexId();
 		VertexId route_id = GetNextVertexId();
-		stop_name_to_vertexes_[stop.name] = { wait_id, route_id };
+		stop_to_vertexes_.push_back({ wait_id, route_id });
 		EdgeId edge = graph_.AddEdge({ wait_id, route_id, settings_.bus_wait_time });
-		edge_id_to_info_[edge] = EdgeInfo()
-			.SetEdgeType(EdgeInfo::EdgeType::WAIT)
-			.SetStop(&stop)
-			.SetWeight(settings_.bus_wait_time);
+		EdgeRecord record;
+		record.type = EdgeInfo::EdgeType::WAIT;
+		record.stop = stop->id;
+		record.weight = settings_.bus_wait_time;
+		SetEdgeRecord(edge, std::move(record));
+		added_edges.push_back(edge);
+	}
+}
+
+void TransportRouter::AddRoutesToGraph() {
+	BusEdges bus_edges;
+	for (const auto& route : db_.GetRoutes()) {
+		CollectRouteEdges(route, std::nullopt, bus_edges);
+	}
+	for (auto& [edge, record] : bus_edges.edges) {
+		SetEdgeRecord(graph_.AddEdge(edge), std::move(record));
 	}
 }
 
-void TransportRouter::AddBusesToGraph() {
-	const auto& buses = db_.GetBuses();
-	for (const auto& bus : buses) {
-		
-		for (auto from = bus.stops.begin(); from != bus.stops.end(); ++from) {
-			Weight weight = 0;
-			auto stop_pair_from = from;
-			auto stop_pair_to = std::next(from);
-			for (; stop_pair_to != bus.stops.end();) {
-				std::optional<int> distance = 
-					db_.GetStopPairDistance((*stop_pair_from)->name, (*stop_pair_to)->name);
-				if (distance.has_value()) {
-					weight += ComputeWeight(*distance);
-				} else {
-					assert(false);
-				}
-				const VertexId from_id = stop_name_to_vertexes_.at((*from)->name).route_id;
-				const VertexId to_id = stop_name_to_vertexes_.at((*stop_pair_to)->name).wait_id;
-				EdgeId edge = graph_.AddEdge({ from_id, to_id, weight });
-				edge_id_to_info_[edge] = EdgeInfo()
-					.SetEdgeType(EdgeInfo::EdgeType::BUS)
-					.SetBus(&bus)
-					.SetSpanCount(static_cast<int>(std::distance(from, stop_pair_to)))
-					.SetWeight(weight);
-				++stop_pair_from;
-				++stop_pair_to;
+void TransportRouter::CollectRouteEdges(const Route& route, std::optional<StopId> from_stop,
+	BusEdges& bus_edges) const {
+	//По пути могут больше не следовать автобусы после изменения справочника
+	if (route.buses.empty()) {
+		return;
+	}
+	//Параллельные ребра между одной парой вершин схлопываются в одно,
+	//побеждает первое ребро с минимальным весом.
+	//Автобусы с одинаковым путем следования дают общие ребра
+	const BusId bus = route.buses.front();
+	const auto all_stops = db_.GetRouteStops(route);
+	for (auto from = all_stops.begin(); from != all_stops.end(); ++from) {
+		if (from_stop && *from != *from_stop) {
+			continue;
+		}
+		Weight weight = 0;
+		auto stop_pair_from = from;
+		auto stop_pair_to = std::next(from);
+		for (; stop_pair_to != all_stops.end();) {
+			std::optional<int> distance =
+				db_.GetStopPairDistance(*stop_pair_from, *stop_pair_to);
+			if (distance.has_value()) {
+				weight += ComputeWeight(*distance);
+			} else {
+				assert(false);
+			}
+			const VertexId from_id = stop_to_vertexes_[*from].route_id;
+			const VertexId to_id = stop_to_vertexes_[*stop_pair_to].wait_id;
+			const int span_count = static_cast<int>(std::distance(from, stop_pair_to));
+			++stop_pair_from;
+			++stop_pair_to;
+			const auto [it, inserted] = bus_edges.index.emplace(
+				std::pair{ from_id, to_id }, bus_edges.edges.size());
+			if (inserted) {
+				bus_edges.edges.push_back({ { from_id, to_id, weight },
+					MakeBusEdgeRecord(route, span_count, weight) });
+				continue;
+			}
+			auto& [edge, record] = bus_edges.edges[it->second];
+			if (weight < edge.weight) {
+				edge.weight = weight;
+				record = MakeBusEdgeRecord(route, span_count, weight);
+			} else if (weight == edge.weight && record.bus != bus
+				&& std::find(record.tied_buses.begin(), record.tied_buses.end(), bus) == record.tied_buses.end()) {
+				record.tied_buses.insert(record.tied_buses.end(), route.buses.begin(), route.buses.end());
 			}
 		}
 	}
 }
 
+void TransportRouter::RebuildStopEdges(StopId stop, std::vector<EdgeId>& removed_edges,
+	std::vector<EdgeId>& added_edges) {
+	//Пути обходятся по возрастанию номера, как при построении графа
+	std::vector<size_t> route_ids;
+	for (const auto bus : db_.GetStopBusIndex().GetBuses(stop)) {
+		route_ids.push_back(db_.GetBus(bus).route_id);
+	}
+	std::sort(route_ids.begin(), route_ids.end());
+	route_ids.erase(std::unique(route_ids.begin(), route_ids.end()), route_ids.end());
+	BusEdges bus_edges;
+	for (const size_t route_id : route_ids) {
+		CollectRouteEdges(db_.GetRoute(route_id), stop, bus_edges);
+	}
+
+	std::vector<bool> is_kept(bus_edges.edges.size());
+	const auto stop_edges = graph_.GetIncidentEdges(stop_to_vertexes_[stop].route_id);
+	for (const EdgeId edge_id : std::vector<EdgeId>(stop_edges.begin(), stop_edges.end())) {
+		const auto& edge = graph_.GetEdge(edge_id);
+		const auto it = bus_edges.index.find({ edge.from, edge.to });
+		if (it != bus_edges.index.end() && bus_edges.edges[it->second].first.weight == edge.weight) {
+			SetEdgeRecord(edge_id, std::move(bus_edges.edges[it->second].second));
+			is_kept[it->second] = true;
+			continue;
+		}
+		graph_.RemoveEdge(edge_id);
+		//Сведения убранного ребра больше не нужны
+		SetEdgeRecord(edge_id, {});
+		removed_edges.push_back(edge_id);
+	}
+	for (size_t i = 0; i < bus_edges.edges.size(); ++i) {
+		if (!is_kept[i]) {
+			auto& [edge, record] = bus_edges.edges[i];
+			const EdgeId edge_id = graph_.AddEdge(edge);
+			SetEdgeRecord(edge_id, std::move(record));
+			added_edges.push_back(edge_id);
+		}
+	}
+}
+
+TransportRouter::EdgeRecord TransportRouter::MakeBusEdgeRecord(
+	const Route& route, int span_count, Weight weight) const {
+	EdgeRecord record;
+	record.type = EdgeInfo::EdgeType::BUS;
+	record.bus = route.buses.front();
+	record.tied_buses.assign(std::next(route.buses.begin()), route.buses.end());
+	record.span_count = span_count;
+	record.weight = weight;
+	return record;
+}
+
+void TransportRouter::SetEdgeRecord(EdgeId edge_id, EdgeRecord record) {
+	//Ребра графа нумеруются подряд, сведения нового ребра дописываются в конец
+	assert(edge_id <= edge_records_.size());
+	if (edge_id == edge_records_.size()) {
+		edge_records_.push_back(std::move(record));
+		return;
+	}
+	edge_records_.GetMutable(edge_id) = std::move(record);
+}
+
 std::vector<TransportRouter::EdgeInfo> TransportRouter::BuildRoute(
 	const std::string_view from, const std::string_view to) const {
 	std::vector<EdgeInfo> result;
 	assert(from != to);
-	if (!stop_name_to_vertexes_.count(from) || !stop_name_to_vertexes_.count(to)) {
+	const auto from_id = db_.FindStopId(from);
+	const auto to_id = db_.FindStopId(to);
+	if (!from_id || !to_id) {
 		return result;
 	}
-	VertexId vertex_from = stop_name_to_vertexes_.at(from).wait_id;
-	VertexId vertex_to = stop_name_to_vertexes_.at(to).wait_id;
+	VertexId vertex_from = stop_to_vertexes_[*from_id].wait_id;
+	VertexId vertex_to = stop_to_vertexes_[*to_id].wait_id;
 	const auto raw_route = router_->BuildRoute(vertex_from, vertex_to);
 	if (!raw_route.has_value()) {
 		return result;
 	}
 	for (const auto edge_id : raw_route->edges) {
-		result.push_back(edge_id_to_info_.at(edge_id));
+		const EdgeRecord& record = edge_records_[edge_id];
+		EdgeInfo info = EdgeInfo()
+			.SetEdgeType(record.type)
+			.SetSpanCount(record.span_count)
+			.SetWeight(record.weight);
+		if (record.type == EdgeInfo::EdgeType::WAIT) {
+			info.SetStop(&db_.GetStop(record.stop));
+		} else {
+			info.SetBus(&db_.GetBus(record.bus));
+			for (const BusId bus : record.tied_buses) {
+				info.AddTiedBus(&db_.GetBus(bus));
+			}
+		}
+		result.push_back(std::move(info));
 	}
 	return result;
 }
 
+void TransportRouter::ReportMemory(memory_report::Report& report) const {
+	using namespace memory_report;
+	size_t edge_records_bytes = edge_records_.GetMemoryUsage();
+	for (const auto& record : edge_records_) {
+		edge_records_bytes += OfVector(record.tied_buses);
+	}
+	report.Add("graph edges", graph_.GetEdgesMemoryUsage())
+		.Add("graph incidence lists", graph_.GetIncidenceListsMemoryUsage())
+		.Add("stop_to_vertexes_", stop_to_vertexes_.GetMemoryUsage())
+		.Add("edge_records_", edge_records_bytes)
+		//Матрица маршрутов хранит строку на каждую вершину графа
+		.Add("routes_internal_data_", router_->GetMemoryUsage(), Growth::QUADRATIC);
+}
+
 TransportRouter::Weight TransportRouter::ComputeWeight(int distance) const {
 	return distance / settings_.bus_velocity * TIME_UNITS_COEFF;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graph.h"
+#include "memory_report.h"
 #include "router.h"
 #include "transport_catalogue.h"
 
@@ -8,11 +9,16 @@
 #include  <optional>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace transport_router {
 
 using transport_catalogue::domain::Bus;
+using transport_catalogue::domain::BusId;
+using transport_catalogue::domain::Route;
 using transport_catalogue::domain::Stop;
+using transport_catalogue::domain::StopId;
 
 struct RoutingSettings {
 	double bus_wait_time = 0;
@@ -39,6 +45,13 @@ class TransportRouter {
 		VertexId route_id;
 	};
 
+	//Хэшер для пары вершин графа
+	struct VertexPairHasher {
+		size_t operator()(const std::pair<VertexId, VertexId>& vertex_pair) const {
+			return vertex_pair.first * 37 + vertex_pair.second;
+		}
+	};
+
 public:
 	struct EdgeInfo{
 		enum class EdgeType {
@@ -47,6 +60,9 @@ public:
 		};
 		EdgeType type;
 		const Bus* bus_ptr = nullptr;
+		//Автобусы, проходящие тот же перегон за то же время,
+		//включая автобусы с тем же путем следования
+		std::vector<const Bus*> tied_buses;
 		const Stop* stop_ptr = nullptr;
 		int span_count = 0;
 		Weight weight = 0;
@@ -59,6 +75,10 @@ public:
 			this->bus_ptr = bus_ptr;
 			return *this;
 		}
+		EdgeInfo& AddTiedBus(const Bus* bus_ptr) {
+			this->tied_buses.push_back(bus_ptr);
+			return *this;
+		}
 		EdgeInfo& SetStop(const Stop* stop_ptr) {
 			this->stop_ptr = stop_ptr;
 			return *this;
@@ -76,12 +96,56 @@ public:
 public:
 	TransportRouter(const transport_catalogue::TransportCatalogue& db, RoutingSettings settings);
 
+	//Маршрутизатор для версии справочника db, полученной из справочника other.
+	//Страницы графа и сведений о ребрах, как и строки матрицы маршрутов,
+	//остаются общими с other до их изменения
+	TransportRouter(const TransportRouter& other, const transport_catalogue::TransportCatalogue& db);
+
 	std::vector<EdgeInfo> BuildRoute(const std::string_view from, const std::string_view to) const;
 
+	//Добавляет в граф остановки, появившиеся в справочнике, и заново строит ребра автобусов,
+	//выходящие из остановок stops. Исчезнувшие и изменившие вес ребра убираются из графа,
+	//маршруты пересчитываются только там, где их затронули убранные и новые ребра
+	void Update(const std::vector<StopId>& stops);
+
+	//Добавляет в отчет объем памяти графа, сведений о ребрах и матрицы маршрутов
+	void ReportMemory(memory_report::Report& report) const;
+
 private:
+	//Сведения о ребре с идентификаторами вместо указателей, чтобы их страницы
+	//можно было разделять между версиями справочника
+	struct EdgeRecord {
+		EdgeInfo::EdgeType type = EdgeInfo::EdgeType::WAIT;
+		StopId stop = 0;
+		BusId bus = 0;
+		std::vector<BusId> tied_buses;
+		int span_count = 0;
+		Weight weight = 0;
+	};
+
+	//Ребра автобусов между парами вершин в порядке появления
+	struct BusEdges {
+		std::vector<std::pair<graph::Edge<Weight>, EdgeRecord>> edges;
+		std::unordered_map<std::pair<VertexId, VertexId>, size_t, VertexPairHasher> index;
+	};
+
 	void BuildRouter();
-	void AddStopsToGraph();
-	void AddBusesToGraph();
+
+	//Добавляет в граф недостающие остановки, идентификаторы новых ребер дописываются в added_edges
+	void AddStopsToGraph(std::vector<EdgeId>& added_edges);
+	void AddRoutesToGraph();
+
+	//Добавляет в bus_edges ребра пути route, начинающиеся в остановке from_stop,
+	//а если она не задана - во всех остановках пути
+	void CollectRouteEdges(const Route& route, std::optional<StopId> from_stop, BusEdges& bus_edges) const;
+
+	//Заменяет ребра автобусов, выходящие из остановки, ребрами проходящих через нее путей.
+	//Ребро с прежним весом остается в графе с новыми сведениями
+	void RebuildStopEdges(StopId stop, std::vector<EdgeId>& removed_edges, std::vector<EdgeId>& added_edges);
+
+	EdgeRecord MakeBusEdgeRecord(const Route& route, int span_count, Weight weight) const;
+
+	void SetEdgeRecord(EdgeId edge_id, EdgeRecord record);
 
 	Weight ComputeWeight(int distance) const;
 
@@ -94,8 +158,10 @@ private:
 
 	RoutingSettings settings_;
 
-	std::unordered_map<std::string_view, StopVertexes> stop_name_to_vertexes_;
-	std::unordered_map<EdgeId, EdgeInfo> edge_id_to_info_;
+	//Вершины графа, индексируются идентификатором остановки
+	transport_catalogue::domain::PagedVector<StopVertexes> stop_to_vertexes_;
+	//Сведения о ребрах, индексируются идентификатором ребра
+	transport_catalogue::domain::PagedVector<EdgeRecord> edge_records_;
 
 	size_t current_vertex_count_ = 0;
 